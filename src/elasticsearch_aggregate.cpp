@@ -0,0 +1,718 @@
+#include "elasticsearch_aggregate.hpp"
+#include "elasticsearch_common.hpp"
+#include "elasticsearch_query.hpp"
+#include "elasticsearch_schema.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/common/types/data_chunk.hpp"
+#include "duckdb/common/types/timestamp.hpp"
+#include "duckdb/logging/logger.hpp"
+#include "duckdb/main/client_config.hpp"
+#include "yyjson.hpp"
+
+#include <cmath>
+#include <unordered_set>
+
+namespace duckdb {
+
+using namespace duckdb_yyjson;
+
+// Global state for scanning aggregation buckets.
+struct ElasticsearchAggregateGlobalState : public GlobalTableFunctionState {
+	std::unique_ptr<ElasticsearchClient> client;
+
+	// Parsed response of the current page and its rows. A row is one bucket per level, preceded by the
+	// aggregations object of the response, stored flat with levels.size() + 1 entries per row.
+	yyjson_doc *response = nullptr;
+	vector<yyjson_val *> rows;
+	idx_t row_count = 0;
+	idx_t current_row_idx = 0;
+
+	// Composite after_key of the current page (points into response), nullptr when there are no more pages.
+	yyjson_val *after_key = nullptr;
+
+	bool finished = false;
+
+	~ElasticsearchAggregateGlobalState() {
+		if (response) {
+			yyjson_doc_free(response);
+		}
+	}
+
+	idx_t MaxThreads() const override {
+		return 1;
+	}
+};
+
+// Build the request body for the next composite page by adding the previous page's after_key.
+static std::string BuildCompositePageRequest(const ElasticsearchAggregateBindData &bind_data, yyjson_val *after_key) {
+	if (!after_key) {
+		return bind_data.request;
+	}
+
+	yyjson_doc *request_doc = yyjson_read(bind_data.request.c_str(), bind_data.request.size(), 0);
+	if (!request_doc) {
+		throw IOException("Failed to parse Elasticsearch aggregation request");
+	}
+	yyjson_mut_doc *doc = yyjson_doc_mut_copy(request_doc, nullptr);
+	yyjson_doc_free(request_doc);
+
+	yyjson_mut_val *aggregation = yyjson_mut_doc_get_root(doc);
+	for (auto &key : bind_data.composite_path) {
+		aggregation = yyjson_mut_obj_get(aggregation, key.c_str());
+	}
+	yyjson_mut_val *composite = yyjson_mut_obj_get(aggregation, "composite");
+	if (!composite || !yyjson_mut_is_obj(composite)) {
+		// Sending the request without "after" would return the first page again.
+		yyjson_mut_doc_free(doc);
+		throw IOException("Elasticsearch aggregation on index " + bind_data.index +
+		                  ": composite aggregation to page not found in the request");
+	}
+	yyjson_mut_obj_remove_key(composite, "after");
+	yyjson_mut_obj_add_val(doc, composite, "after", yyjson_val_mut_copy(doc, after_key));
+
+	std::string result;
+	char *json_str = yyjson_mut_write(doc, 0, nullptr);
+	if (json_str) {
+		result = json_str;
+		free(json_str);
+	}
+	yyjson_mut_doc_free(doc);
+	return result;
+}
+
+// Log the accuracy of an approximate terms aggregation. doc_count_error_upper_bound is the maximum count a
+// bucket missing from the top buckets could have, sum_other_doc_count the documents outside the top buckets.
+// Written to the logger of the client context, independent of HTTP logging.
+static void LogTermsAccuracy(ClientContext &context, const ElasticsearchAggregateBindData &bind_data,
+                             yyjson_val *groups) {
+	auto &logger = Logger::Get(context);
+	if (!groups || !logger.ShouldLog("Elasticsearch", LogLevel::LOG_INFO)) {
+		return;
+	}
+	yyjson_val *error_bound = yyjson_obj_get(groups, "doc_count_error_upper_bound");
+	yyjson_val *other_count = yyjson_obj_get(groups, "sum_other_doc_count");
+	std::string message = "Approximate terms aggregation on index " + bind_data.index +
+	                      ": doc_count_error_upper_bound=" +
+	                      std::to_string(static_cast<int64_t>(yyjson_get_num(error_bound))) +
+	                      ", sum_other_doc_count=" + std::to_string(static_cast<int64_t>(yyjson_get_num(other_count)));
+	logger.WriteLog("Elasticsearch", LogLevel::LOG_INFO, message);
+}
+
+// Get the bucket aggregation of a level below its parent bucket (the aggregations object for level 0). The paged
+// composite aggregation is found through the names of composite_path, which may contain dots.
+static yyjson_val *GetLevelAggregation(const ElasticsearchAggregateBindData &bind_data, yyjson_val *parent,
+                                       idx_t level) {
+	if (level > 0 || bind_data.mode != ElasticsearchAggregateMode::COMPOSITE || bind_data.composite_path.empty()) {
+		return GetValueByPath(parent, bind_data.levels[level]);
+	}
+	yyjson_val *aggregation = parent;
+	for (idx_t i = 1; i < bind_data.composite_path.size(); i += 2) {
+		aggregation = yyjson_obj_get(aggregation, bind_data.composite_path[i].c_str());
+	}
+	return aggregation;
+}
+
+// Add a row for every combination of buckets of the nested bucket aggregations below the partial row.
+static void ExpandBuckets(const ElasticsearchAggregateBindData &bind_data, ElasticsearchAggregateGlobalState &state,
+                          vector<yyjson_val *> &row) {
+	idx_t level = row.size() - 1;
+	if (level == bind_data.levels.size()) {
+		state.rows.insert(state.rows.end(), row.begin(), row.end());
+		state.row_count++;
+		return;
+	}
+	// The hits array of a top_hits aggregation is a level of its own, each hit is a bucket.
+	yyjson_val *aggregation = GetLevelAggregation(bind_data, row.back(), level);
+	yyjson_val *buckets = aggregation && !yyjson_is_arr(aggregation) ? yyjson_obj_get(aggregation, "buckets")
+	                                                                  : aggregation;
+	if (!buckets || !yyjson_is_arr(buckets)) {
+		return;
+	}
+	size_t idx, max;
+	yyjson_val *bucket;
+	yyjson_arr_foreach(buckets, idx, max, bucket) {
+		row.push_back(bucket);
+		ExpandBuckets(bind_data, state, row);
+		row.pop_back();
+	}
+}
+
+// Fetch the next page of buckets into the global state.
+static void FetchAggregatePage(ClientContext &context, const ElasticsearchAggregateBindData &bind_data,
+                               ElasticsearchAggregateGlobalState &state) {
+	std::string request = BuildCompositePageRequest(bind_data, state.after_key);
+
+	auto response = state.client->Aggregate(bind_data.index, request);
+	if (!response.success) {
+		throw IOException("Elasticsearch aggregation failed: " + response.error_message);
+	}
+
+	// The previous page (and its after_key) is no longer needed.
+	if (state.response) {
+		yyjson_doc_free(state.response);
+		state.response = nullptr;
+	}
+	state.rows.clear();
+	state.row_count = 0;
+	state.current_row_idx = 0;
+	state.after_key = nullptr;
+
+	state.response = yyjson_read(response.body.c_str(), response.body.size(), 0);
+	if (!state.response) {
+		throw IOException("Failed to parse Elasticsearch aggregation response");
+	}
+
+	yyjson_val *aggregations = yyjson_obj_get(yyjson_doc_get_root(state.response), "aggregations");
+	if (!aggregations) {
+		return;
+	}
+	vector<yyjson_val *> row {aggregations};
+	ExpandBuckets(bind_data, state, row);
+
+	// The first bucket aggregation is the one that is paged (composite) or limited in size (terms, all buckets).
+	yyjson_val *groups = bind_data.levels.empty() ? nullptr : GetLevelAggregation(bind_data, aggregations, 0);
+	yyjson_val *group_buckets = groups ? yyjson_obj_get(groups, "buckets") : nullptr;
+	idx_t bucket_count = group_buckets && yyjson_is_arr(group_buckets) ? yyjson_arr_size(group_buckets) : 0;
+
+	// Terms and grid aggregations are read in one request. Documents without a value are counted by the
+	// missing aggregation next to levels[0], whose bucket has no key and becomes the NULL group.
+	if (bind_data.mode == ElasticsearchAggregateMode::ALL_BUCKETS && bucket_count >= bind_data.page_size) {
+		throw IOException("Elasticsearch aggregation on index " + bind_data.index + " returned the maximum of " +
+		                  std::to_string(bind_data.page_size) +
+		                  " buckets, the result would be incomplete. Use fewer groups (e.g. a lower geohash "
+		                  "precision) or SET elasticsearch_aggregate_pushdown = false");
+	}
+	if (bind_data.mode == ElasticsearchAggregateMode::TERMS ||
+	    bind_data.mode == ElasticsearchAggregateMode::ALL_BUCKETS) {
+		const auto &groups_path = bind_data.levels[0];
+		auto parent_end = groups_path.rfind('.');
+		string missing_path = parent_end == string::npos ? "missing" : groups_path.substr(0, parent_end) + ".missing";
+		yyjson_val *missing = GetValueByPath(aggregations, missing_path);
+		yyjson_val *missing_count = missing ? yyjson_obj_get(missing, "doc_count") : nullptr;
+		if (missing_count && yyjson_is_num(missing_count) && yyjson_get_num(missing_count) > 0) {
+			state.rows.push_back(aggregations);
+			state.rows.push_back(missing);
+			state.row_count++;
+		}
+		if (bind_data.mode == ElasticsearchAggregateMode::TERMS) {
+			LogTermsAccuracy(context, bind_data, groups);
+		}
+		return;
+	}
+
+	if (bind_data.mode != ElasticsearchAggregateMode::COMPOSITE) {
+		return;
+	}
+
+	// A full page may be followed by more buckets, a shorter one is the last page (unless buckets are filtered).
+	bool full_page = bucket_count > 0 && bucket_count >= bind_data.page_size;
+	if (groups && (full_page || bind_data.filtered_buckets)) {
+		state.after_key = yyjson_obj_get(groups, "after_key");
+	}
+}
+
+// Convert a bucket key or metric value to a DuckDB value of the given type.
+// Elasticsearch returns dates as epoch milliseconds in bucket keys and metric values.
+static Value ConvertAggregateValue(yyjson_val *val, const LogicalType &type, double divisor) {
+	Value result;
+	if (!val || yyjson_is_null(val)) {
+		return Value(type);
+	} else if (yyjson_is_str(val)) {
+		result = Value(yyjson_get_str(val));
+	} else if (yyjson_is_bool(val)) {
+		result = Value::BOOLEAN(yyjson_get_bool(val));
+	} else if (yyjson_is_uint(val)) {
+		result = Value::UBIGINT(yyjson_get_uint(val));
+	} else if (yyjson_is_sint(val)) {
+		result = Value::BIGINT(yyjson_get_sint(val));
+	} else if (yyjson_is_real(val)) {
+		result = Value::DOUBLE(yyjson_get_real(val));
+	} else {
+		return Value(type);
+	}
+
+	// Histogram keys are multiples of the interval, up to the rounding of floor(x / w) * w (0.30000000000000004 for
+	// 3 * 0.1), so the quotient is rounded to the integer it stands for.
+	if (divisor != 1 && result.type().IsNumeric()) {
+		result = Value::DOUBLE(std::round(result.GetValue<double>() / divisor));
+	}
+	if (type.id() == LogicalTypeId::TIMESTAMP && result.type().IsNumeric()) {
+		return Value::TIMESTAMP(Timestamp::FromEpochMs(static_cast<int64_t>(result.GetValue<double>())));
+	}
+	if (!result.DefaultTryCastAs(type)) {
+		return Value(type);
+	}
+	return result;
+}
+
+// Read a column from the first document of a top_hits aggregation in the bucket (or from the bucket itself when
+// it is a hit), the same way the document scan reads it from a search hit.
+static void ReadTopHitColumn(const ElasticsearchAggregateBindData &bind_data,
+                             const ElasticsearchAggregateColumn &column, yyjson_val *bucket, Vector &result,
+                             idx_t row_idx, vector<VariantValue> &variant_values) {
+	yyjson_val *hit = bucket;
+	if (column.hits_path != ".") {
+		yyjson_val *hits = GetValueByPath(bucket, column.hits_path);
+		hit = hits && yyjson_is_arr(hits) ? yyjson_arr_get_first(hits) : nullptr;
+	}
+	yyjson_val *source = hit ? yyjson_obj_get(hit, "_source") : nullptr;
+
+	if (column.value_path == "_unmapped_") {
+		variant_values.push_back(CollectUnmappedFields(source, bind_data.mapped_paths));
+	} else if (column.value_path == "_id") {
+		yyjson_val *id_val = hit ? yyjson_obj_get(hit, "_id") : nullptr;
+		if (id_val && yyjson_is_str(id_val)) {
+			FlatVector::GetData<string_t>(result)[row_idx] = StringVector::AddString(result, yyjson_get_str(id_val));
+		} else {
+			FlatVector::SetNull(result, row_idx, true);
+		}
+	} else {
+		yyjson_val *val = source ? GetValueByPath(source, column.value_path) : nullptr;
+		ConvertJSONToDuckDB(val, result, row_idx, column.type, column.es_type);
+	}
+}
+
+// Initialize global state and fetch the first page of buckets.
+static unique_ptr<GlobalTableFunctionState> ElasticsearchAggregateInitGlobal(ClientContext &context,
+                                                                             TableFunctionInitInput &input) {
+	auto &bind_data = input.bind_data->Cast<ElasticsearchAggregateBindData>();
+	auto state = make_uniq<ElasticsearchAggregateGlobalState>();
+
+	state->client = make_uniq<ElasticsearchClient>(bind_data.config, bind_data.logger);
+	FetchAggregatePage(context, bind_data, *state);
+
+	return std::move(state);
+}
+
+// Main scan function, emits one row per combination of buckets.
+static void ElasticsearchAggregateScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
+	auto &bind_data = data.bind_data->Cast<ElasticsearchAggregateBindData>();
+	auto &state = data.global_state->Cast<ElasticsearchAggregateGlobalState>();
+
+	// VARIANT columns (_unmapped_ of top hits, raw aggregation results) are collected as VariantValues and written
+	// after the scan loop.
+	vector<vector<VariantValue>> variant_values(bind_data.columns.size());
+	idx_t row_width = bind_data.levels.size() + 1;
+
+	idx_t output_idx = 0;
+	while (output_idx < STANDARD_VECTOR_SIZE && !state.finished) {
+		if (state.current_row_idx >= state.row_count) {
+			if (!state.after_key) {
+				state.finished = true;
+				break;
+			}
+			FetchAggregatePage(context, bind_data, state);
+			continue;
+		}
+
+		yyjson_val **row = &state.rows[state.current_row_idx * row_width];
+		for (idx_t col_idx = 0; col_idx < bind_data.columns.size(); col_idx++) {
+			const auto &column = bind_data.columns[col_idx];
+			yyjson_val *bucket = row[MinValue<idx_t>(column.level, row_width - 1)];
+			if (!column.hits_path.empty()) {
+				ReadTopHitColumn(bind_data, column, bucket, output.data[col_idx], output_idx, variant_values[col_idx]);
+				continue;
+			}
+			if (!column.null_if_zero_path.empty()) {
+				yyjson_val *count_val = GetValueByPath(bucket, column.null_if_zero_path);
+				if (!count_val || (yyjson_is_num(count_val) && yyjson_get_num(count_val) == 0)) {
+					output.SetValue(col_idx, output_idx, Value(column.type));
+					continue;
+				}
+			}
+			yyjson_val *val = GetValueByPath(bucket, column.value_path);
+			switch (column.type.id()) {
+			case LogicalTypeId::VARIANT:
+				variant_values[col_idx].push_back(ConvertYyjsonToVariantValue(val));
+				break;
+			case LogicalTypeId::STRUCT:
+			case LogicalTypeId::LIST:
+				ConvertJSONToDuckDB(val, output.data[col_idx], output_idx, column.type, column.es_type);
+				break;
+			default:
+				output.SetValue(col_idx, output_idx, ConvertAggregateValue(val, column.type, column.divisor));
+				break;
+			}
+		}
+
+		output_idx++;
+		state.current_row_idx++;
+	}
+
+	for (idx_t col_idx = 0; col_idx < bind_data.columns.size(); col_idx++) {
+		if (bind_data.columns[col_idx].type.id() == LogicalTypeId::VARIANT && output_idx > 0) {
+			VariantValue::ToVARIANT(variant_values[col_idx], output.data[col_idx]);
+		}
+	}
+
+	output.SetCardinality(output_idx);
+}
+
+// Aggregations whose result is a single bucket: a doc_count and sub-aggregations, but no buckets array.
+static const std::unordered_set<std::string> SINGLE_BUCKET_AGGREGATIONS = {
+    "filter", "global", "nested", "reverse_nested", "missing", "sampler", "diversified_sampler", "random_sampler",
+    "children", "parent"};
+
+// Aggregations whose result is an array of buckets.
+static const std::unordered_set<std::string> MULTI_BUCKET_AGGREGATIONS = {
+    "terms", "multi_terms", "rare_terms", "significant_terms", "significant_text", "composite", "histogram",
+    "date_histogram", "auto_date_histogram", "variable_width_histogram", "range", "date_range", "ip_range",
+    "ip_prefix", "filters", "adjacency_matrix", "geohash_grid", "geotile_grid", "geohex_grid", "categorize_text",
+    "time_series"};
+
+// Bucket aggregations returning keyed buckets (an object instead of an array) with "keyed": true.
+static const std::unordered_set<std::string> KEYED_AGGREGATIONS = {
+    "filters", "range", "date_range", "ip_range", "ip_prefix", "histogram", "date_histogram"};
+
+// Metric and pipeline aggregations with a single numeric "value".
+static const std::unordered_set<std::string> SINGLE_VALUE_METRICS = {
+    "avg", "sum", "min", "max", "value_count", "cardinality", "weighted_avg", "median_absolute_deviation", "rate",
+    "avg_bucket", "sum_bucket", "min_bucket", "max_bucket", "derivative", "cumulative_sum", "cumulative_cardinality",
+    "moving_fn", "bucket_script", "serial_diff", "normalize"};
+
+// Get the type of an aggregation definition, the key next to "aggs" and "meta".
+static std::string GetAggregationType(yyjson_mut_val *definition) {
+	size_t idx, max;
+	yyjson_mut_val *key, *val;
+	yyjson_mut_obj_foreach(definition, idx, max, key, val) {
+		std::string name = yyjson_mut_get_str(key);
+		if (name != "aggs" && name != "aggregations" && name != "meta") {
+			return name;
+		}
+	}
+	return "";
+}
+
+// Infers the output columns of a raw aggregation tree from its definition. Bucket aggregations become levels whose
+// buckets are flattened into rows, with a key column named after the aggregation (one column per source for
+// composite aggregations) and a <name>_doc_count column. Single-bucket aggregations add a <name>_doc_count column
+// to the row they are in, metrics a column named after the metric: single-value metrics are numbers, stats a STRUCT
+// and any other result a VARIANT holding the JSON value.
+struct AggregateTreeInference {
+	yyjson_mut_doc *doc;
+	const ElasticsearchSchema &schema;
+	vector<std::string> levels;
+	vector<ElasticsearchAggregateColumn> columns;
+	std::unordered_set<std::string> column_names;
+	// Composite aggregation at the top level, its page size and the keys from the request root to it.
+	bool composite = false;
+	idx_t page_size = 0;
+	vector<std::string> composite_path;
+
+	AggregateTreeInference(yyjson_mut_doc *doc_p, const ElasticsearchSchema &schema_p)
+	    : doc(doc_p), schema(schema_p) {
+	}
+
+	void AddColumn(const std::string &name, const LogicalType &type, idx_t level, const std::string &value_path) {
+		if (!column_names.insert(name).second) {
+			throw BinderException("elasticsearch_aggregate: duplicate output column \"%s\"", name);
+		}
+		ElasticsearchAggregateColumn column;
+		column.name = name;
+		column.type = type;
+		column.level = level;
+		column.value_path = value_path;
+		columns.push_back(std::move(column));
+	}
+
+	// Get the type of a field from the mapping. Bucket keys and metrics of dates are epoch milliseconds.
+	LogicalType GetFieldType(yyjson_mut_val *body) {
+		yyjson_mut_val *field = yyjson_mut_obj_get(body, "field");
+		if (!field || !yyjson_mut_is_str(field)) {
+			return LogicalType::VARCHAR;
+		}
+		std::string path = yyjson_mut_get_str(field);
+		auto it = schema.es_type_map.find(path);
+		std::string es_type;
+		if (it != schema.es_type_map.end()) {
+			es_type = it->second;
+		} else {
+			// Multi-fields (e.g. name.keyword) have their own type.
+			auto separator = path.rfind('.');
+			auto subfields = separator == string::npos ? schema.subfields.end()
+			                                           : schema.subfields.find(path.substr(0, separator));
+			if (subfields == schema.subfields.end()) {
+				return LogicalType::VARCHAR;
+			}
+			for (const auto &subfield : subfields->second) {
+				if (subfield.path == path) {
+					es_type = subfield.es_type;
+				}
+			}
+		}
+		if (es_type == "long" || es_type == "integer" || es_type == "short" || es_type == "byte") {
+			return LogicalType::BIGINT;
+		} else if (es_type == "double" || es_type == "float" || es_type == "half_float" ||
+		           es_type == "scaled_float" || es_type == "unsigned_long") {
+			return LogicalType::DOUBLE;
+		} else if (es_type == "boolean") {
+			return LogicalType::BOOLEAN;
+		} else if (es_type == "date" || es_type == "date_nanos") {
+			return LogicalType::TIMESTAMP;
+		}
+		return LogicalType::VARCHAR;
+	}
+
+	// Get the type of a bucket key.
+	LogicalType GetKeyType(const std::string &type, yyjson_mut_val *body) {
+		if (type == "terms" || type == "rare_terms" || type == "significant_terms") {
+			return GetFieldType(body);
+		} else if (type == "histogram" || type == "variable_width_histogram") {
+			return LogicalType::DOUBLE;
+		} else if (type == "date_histogram" || type == "auto_date_histogram") {
+			return LogicalType::TIMESTAMP;
+		} else if (type == "time_series") {
+			return LogicalType::VARIANT();
+		}
+		return LogicalType::VARCHAR;
+	}
+
+	// Infer the columns of the aggregations in container (an "aggs" object, reached through the request keys of
+	// container_path) at the given level. Sub-aggregations of single-bucket aggregations belong to the same level,
+	// with the aggregation name as path prefix. multi_bucket collects the one bucket aggregation of the level, and
+	// multi_bucket_keys the request keys to it.
+	void InferAggregations(yyjson_mut_val *container, const vector<std::string> &container_path, idx_t level,
+	                       const std::string &prefix, std::string &multi_bucket_path,
+	                       vector<std::string> &multi_bucket_keys, yyjson_mut_val *&multi_bucket) {
+		if (!container || !yyjson_mut_is_obj(container)) {
+			throw BinderException("elasticsearch_aggregate: aggregations must be a JSON object");
+		}
+		size_t idx, max;
+		yyjson_mut_val *key, *definition;
+		yyjson_mut_obj_foreach(container, idx, max, key, definition) {
+			std::string name = yyjson_mut_get_str(key);
+			std::string path = prefix + name;
+			std::string type = GetAggregationType(definition);
+			yyjson_mut_val *body = yyjson_mut_obj_get(definition, type.c_str());
+
+			if (SINGLE_BUCKET_AGGREGATIONS.count(type)) {
+				AddColumn(name + "_doc_count", LogicalType::BIGINT, level, path + ".doc_count");
+				const char *sub_aggs_key = yyjson_mut_obj_get(definition, "aggs") ? "aggs" : "aggregations";
+				yyjson_mut_val *sub_aggs = yyjson_mut_obj_get(definition, sub_aggs_key);
+				if (sub_aggs) {
+					vector<std::string> sub_aggs_path = container_path;
+					sub_aggs_path.push_back(name);
+					sub_aggs_path.push_back(sub_aggs_key);
+					InferAggregations(sub_aggs, sub_aggs_path, level, path + ".", multi_bucket_path,
+					                  multi_bucket_keys, multi_bucket);
+				}
+			} else if (MULTI_BUCKET_AGGREGATIONS.count(type)) {
+				if (multi_bucket) {
+					throw BinderException("elasticsearch_aggregate: only one bucket aggregation per level is "
+					                      "supported, found \"%s\" and \"%s\"",
+					                      multi_bucket_path, path);
+				}
+				multi_bucket_path = path;
+				multi_bucket_keys = container_path;
+				multi_bucket_keys.push_back(name);
+				multi_bucket = definition;
+			} else if (SINGLE_VALUE_METRICS.count(type)) {
+				LogicalType column_type = LogicalType::DOUBLE;
+				if (type == "value_count" || type == "cardinality") {
+					column_type = LogicalType::BIGINT;
+				} else if ((type == "min" || type == "max") && GetFieldType(body).id() == LogicalTypeId::TIMESTAMP) {
+					column_type = LogicalType::TIMESTAMP;
+				}
+				AddColumn(name, column_type, level, path + ".value");
+			} else if (type == "stats") {
+				child_list_t<LogicalType> children {{"count", LogicalType::BIGINT},
+				                                    {"min", LogicalType::DOUBLE},
+				                                    {"max", LogicalType::DOUBLE},
+				                                    {"avg", LogicalType::DOUBLE},
+				                                    {"sum", LogicalType::DOUBLE}};
+				AddColumn(name, LogicalType::STRUCT(std::move(children)), level, path);
+			} else {
+				AddColumn(name, LogicalType::VARIANT(), level, path);
+			}
+		}
+	}
+
+	// Infer the levels and columns of the aggregation tree below container, reached through the request keys of
+	// container_path.
+	void InferLevel(yyjson_mut_val *container, const vector<std::string> &container_path, idx_t level) {
+		std::string multi_bucket_path;
+		vector<std::string> multi_bucket_keys;
+		yyjson_mut_val *multi_bucket = nullptr;
+		InferAggregations(container, container_path, level, "", multi_bucket_path, multi_bucket_keys, multi_bucket);
+		if (!multi_bucket) {
+			return;
+		}
+
+		std::string name = multi_bucket_path.substr(multi_bucket_path.rfind('.') + 1);
+		std::string type = GetAggregationType(multi_bucket);
+		yyjson_mut_val *body = yyjson_mut_obj_get(multi_bucket, type.c_str());
+		levels.push_back(multi_bucket_path);
+		idx_t bucket_level = level + 1;
+
+		// Buckets are read from arrays, keyed buckets would be an object.
+		if (KEYED_AGGREGATIONS.count(type) && body && yyjson_mut_is_obj(body)) {
+			yyjson_mut_obj_remove_key(body, "keyed");
+			yyjson_mut_obj_add_bool(doc, body, "keyed", false);
+		}
+
+		if (type == "composite") {
+			// One key column per source, e.g. {"sources": [{"city": {"terms": {"field": "city"}}}]}.
+			yyjson_mut_val *sources = body ? yyjson_mut_obj_get(body, "sources") : nullptr;
+			size_t idx, max;
+			yyjson_mut_val *source;
+			yyjson_mut_arr_foreach(sources, idx, max, source) {
+				size_t source_idx, source_max;
+				yyjson_mut_val *source_key, *source_definition;
+				yyjson_mut_obj_foreach(source, source_idx, source_max, source_key, source_definition) {
+					std::string source_name = yyjson_mut_get_str(source_key);
+					std::string source_type = GetAggregationType(source_definition);
+					AddColumn(source_name,
+					          GetKeyType(source_type, yyjson_mut_obj_get(source_definition, source_type.c_str())),
+					          bucket_level, "key." + source_name);
+				}
+			}
+			if (level == 0) {
+				composite = true;
+				composite_path = multi_bucket_keys;
+				yyjson_mut_val *size = yyjson_mut_obj_get(body, "size");
+				page_size = size && yyjson_mut_is_int(size) ? yyjson_mut_get_uint(size) : 10;
+			}
+		} else if (type == "multi_terms") {
+			AddColumn(name, LogicalType::VARCHAR, bucket_level, "key_as_string");
+		} else {
+			AddColumn(name, GetKeyType(type, body), bucket_level, "key");
+		}
+		AddColumn(name + "_doc_count", LogicalType::BIGINT, bucket_level, "doc_count");
+		if (type == "significant_terms" || type == "significant_text") {
+			AddColumn(name + "_score", LogicalType::DOUBLE, bucket_level, "score");
+			AddColumn(name + "_bg_count", LogicalType::BIGINT, bucket_level, "bg_count");
+		}
+
+		const char *sub_aggs_key = yyjson_mut_obj_get(multi_bucket, "aggs") ? "aggs" : "aggregations";
+		yyjson_mut_val *sub_aggs = yyjson_mut_obj_get(multi_bucket, sub_aggs_key);
+		if (sub_aggs) {
+			vector<std::string> sub_aggs_path = multi_bucket_keys;
+			sub_aggs_path.push_back(sub_aggs_key);
+			InferLevel(sub_aggs, sub_aggs_path, bucket_level);
+		}
+	}
+};
+
+// Bind function for elasticsearch_aggregate: infers the output columns from the aggs parameter.
+static unique_ptr<FunctionData> ElasticsearchAggregateBind(ClientContext &context, TableFunctionBindInput &input,
+                                                           vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<ElasticsearchAggregateBindData>();
+
+	// Capture logger from ClientContext if HTTP logging is enabled.
+	auto &client_config = ClientConfig::GetConfig(context);
+	if (client_config.enable_http_logging) {
+		bind_data->logger = context.logger;
+	}
+	InitElasticsearchConfig(context, bind_data->config);
+
+	int64_t sample_size = 0;
+	Value setting_val;
+	if (context.TryGetCurrentSetting("elasticsearch_sample_size", setting_val)) {
+		sample_size = IntegerValue::Get(setting_val);
+	}
+
+	std::string query, aggs;
+	for (auto &kv : input.named_parameters) {
+		if (SetElasticsearchConfigParameter(kv.first, kv.second, bind_data->config)) {
+			continue;
+		} else if (kv.first == "index") {
+			bind_data->index = StringValue::Get(kv.second);
+		} else if (kv.first == "query") {
+			query = StringValue::Get(kv.second);
+		} else if (kv.first == "aggs") {
+			aggs = StringValue::Get(kv.second);
+		}
+	}
+
+	// Validate required parameters.
+	if (bind_data->config.host.empty()) {
+		throw InvalidInputException("elasticsearch_aggregate requires 'host' parameter");
+	}
+	if (bind_data->index.empty()) {
+		throw InvalidInputException("elasticsearch_aggregate requires 'index' parameter");
+	}
+	if (aggs.empty()) {
+		throw InvalidInputException("elasticsearch_aggregate requires 'aggs' parameter");
+	}
+
+	// The mapping provides the types of bucket keys, it is shared with elasticsearch_query through the bind cache.
+	auto schema =
+	    ResolveElasticsearchSchema(bind_data->config, bind_data->index, query, sample_size, bind_data->logger);
+
+	yyjson_doc *aggs_doc = yyjson_read(aggs.c_str(), aggs.size(), 0);
+	if (!aggs_doc || !yyjson_is_obj(yyjson_doc_get_root(aggs_doc))) {
+		if (aggs_doc) {
+			yyjson_doc_free(aggs_doc);
+		}
+		throw InvalidInputException("elasticsearch_aggregate: 'aggs' must be a JSON object");
+	}
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	yyjson_mut_val *aggs_val = yyjson_val_mut_copy(doc, yyjson_doc_get_root(aggs_doc));
+	yyjson_doc_free(aggs_doc);
+
+	AggregateTreeInference inference(doc, schema);
+	try {
+		inference.InferLevel(aggs_val, {"aggs"}, 0);
+	} catch (...) {
+		yyjson_mut_doc_free(doc);
+		throw;
+	}
+	if (inference.columns.empty()) {
+		yyjson_mut_doc_free(doc);
+		throw InvalidInputException("elasticsearch_aggregate: 'aggs' does not contain any aggregation");
+	}
+
+	// Build the request: {"query": ..., "aggs": ...}.
+	yyjson_mut_val *root = yyjson_mut_obj(doc);
+	yyjson_mut_doc_set_root(doc, root);
+	if (!query.empty()) {
+		yyjson_doc *query_doc = yyjson_read(query.c_str(), query.size(), 0);
+		if (!query_doc) {
+			yyjson_mut_doc_free(doc);
+			throw InvalidInputException("elasticsearch_aggregate: 'query' must be valid JSON");
+		}
+		// The query parameter is the query clause, like for elasticsearch_query.
+		yyjson_mut_obj_add_val(doc, root, "query", yyjson_val_mut_copy(doc, yyjson_doc_get_root(query_doc)));
+		yyjson_doc_free(query_doc);
+	}
+	yyjson_mut_obj_add_val(doc, root, "aggs", aggs_val);
+	char *json_str = yyjson_mut_write(doc, 0, nullptr);
+	if (json_str) {
+		bind_data->request = json_str;
+		free(json_str);
+	}
+	yyjson_mut_doc_free(doc);
+
+	// A top-level composite aggregation is paged. Sub-aggregations may drop buckets (bucket_selector), so paging
+	// continues until Elasticsearch returns no after_key.
+	bind_data->mode = inference.composite ? ElasticsearchAggregateMode::COMPOSITE : ElasticsearchAggregateMode::SINGLE;
+	bind_data->page_size = inference.page_size;
+	bind_data->filtered_buckets = true;
+	bind_data->levels = std::move(inference.levels);
+	bind_data->composite_path = std::move(inference.composite_path);
+	for (auto &column : inference.columns) {
+		names.push_back(column.name);
+		return_types.push_back(column.type);
+	}
+	bind_data->columns = std::move(inference.columns);
+
+	return std::move(bind_data);
+}
+
+TableFunction GetElasticsearchAggregateFunction() {
+	TableFunction elasticsearch_aggregate("elasticsearch_aggregate", {}, ElasticsearchAggregateScan,
+	                                      ElasticsearchAggregateBind, ElasticsearchAggregateInitGlobal);
+
+	// Named parameters.
+	AddElasticsearchConfigParameters(elasticsearch_aggregate);
+	elasticsearch_aggregate.named_parameters["index"] = LogicalType::VARCHAR;
+	elasticsearch_aggregate.named_parameters["query"] = LogicalType::VARCHAR;
+	elasticsearch_aggregate.named_parameters["aggs"] = LogicalType::VARCHAR;
+	return elasticsearch_aggregate;
+}
+
+void RegisterElasticsearchAggregateFunction(ExtensionLoader &loader) {
+	loader.RegisterFunction(GetElasticsearchAggregateFunction());
+}
+
+} // namespace duckdb
@@ -0,0 +1,1632 @@
+#include "elasticsearch_aggregate_pushdown.hpp"
+#include "elasticsearch_aggregate.hpp"
+#include "elasticsearch_common.hpp"
+#include "elasticsearch_filter_pushdown.hpp"
+#include "elasticsearch_optimizer.hpp"
+#include "elasticsearch_query.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/optimizer/column_binding_replacer.hpp"
+#include "duckdb/optimizer/optimizer.hpp"
+#include "duckdb/planner/binder.hpp"
+#include "duckdb/planner/expression/bound_aggregate_expression.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+#include "duckdb/planner/expression/bound_unnest_expression.hpp"
+#include "duckdb/planner/expression/bound_window_expression.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
+#include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/planner/filter/in_filter.hpp"
+#include "duckdb/planner/filter/null_filter.hpp"
+#include "duckdb/planner/operator/logical_aggregate.hpp"
+#include "duckdb/planner/operator/logical_distinct.hpp"
+#include "duckdb/planner/operator/logical_filter.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
+#include "duckdb/planner/operator/logical_unnest.hpp"
+#include "duckdb/planner/operator/logical_window.hpp"
+#include "yyjson.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace duckdb {
+
+using namespace duckdb_yyjson;
+
+// Size of geohash_grid aggregations, which return all buckets in one request, the Elasticsearch default for grids.
+// They are not paginated, a response with this many buckets fails the scan instead of returning an incomplete result.
+static constexpr idx_t ALL_BUCKETS_SIZE = 10000;
+
+// Largest geohash_grid precision whose cell count (32^precision) is below ALL_BUCKETS_SIZE: 32^2 = 1024 cells,
+// while precision 3 has 32768. Groups on finer geohashes could exceed the size, they fall back to the document scan.
+static constexpr int64_t MAX_GEOHASH_GRID_PRECISION = 2;
+
+// Largest size of a top_hits aggregation, the default index.max_inner_result_window of Elasticsearch.
+static constexpr idx_t MAX_TOP_HITS_SIZE = 100;
+
+// Elasticsearch types that support stats aggregations (sum, min, max, avg) and histograms. half_float and
+// scaled_float are left out: their doc values are rounded, so results would differ from DuckDB's over _source.
+static const std::unordered_set<string> NUMERIC_ES_TYPES = {"long", "integer", "short", "byte", "double", "float"};
+
+// Strip a cast of a numeric expression to DOUBLE. DuckDB inserts these casts for arithmetic on integer
+// columns (e.g. amount / 10) and for aggregates without a native overload for the column type (e.g. sum(float)).
+// Elasticsearch computes histograms and stats in double precision, so the cast does not change the result.
+static const Expression &StripDoubleCast(const Expression &expr) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_CAST && expr.return_type.id() == LogicalTypeId::DOUBLE) {
+		auto &cast_expr = expr.Cast<BoundCastExpression>();
+		if (cast_expr.child->return_type.IsNumeric()) {
+			return *cast_expr.child;
+		}
+	}
+	return expr;
+}
+
+// Strip a numeric cast that does not change the order of values: widening to DOUBLE or between integer types.
+// DuckDB inserts these when comparing aggregates with constants of another type (e.g. count(*) > 1.5).
+static const Expression &StripOrderPreservingCast(const Expression &expr) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CAST) {
+		return expr;
+	}
+	auto &cast_expr = expr.Cast<BoundCastExpression>();
+	auto &source_type = cast_expr.child->return_type;
+	auto &target_type = expr.return_type;
+	if (source_type.IsNumeric() &&
+	    (target_type.id() == LogicalTypeId::DOUBLE || (source_type.IsIntegral() && target_type.IsIntegral()))) {
+		return *cast_expr.child;
+	}
+	return expr;
+}
+
+// Builder for the aggregation request and the output columns of the replacement scan.
+struct AggregateRequestBuilder {
+	yyjson_mut_doc *doc;
+	const ElasticsearchScanMatch &match;
+	const ElasticsearchSchema &schema;
+
+	// Composite sources, one per GROUP BY expression.
+	yyjson_mut_val *sources;
+	// Body of a geohash_grid aggregation replacing the composite aggregation (a single ST_GeoHash group).
+	yyjson_mut_val *geohash_grid = nullptr;
+	// Metric sub-aggregations of each bucket.
+	yyjson_mut_val *metrics;
+	// Shared sub-aggregation name per type and field, e.g. one stats for sum/min/max/avg of the same field.
+	std::unordered_map<string, string> shared_metrics;
+	idx_t metric_count = 0;
+
+	// Filter sub-aggregations of FILTER (WHERE ...) clauses, one per distinct filter query. Each has its own
+	// metrics, which replace the metrics of the bucket between EnterFilter and LeaveFilter.
+	struct FilterScope {
+		string name;
+		yyjson_mut_val *aggregation;
+		yyjson_mut_val *metrics;
+		std::unordered_map<string, string> shared_metrics;
+	};
+	vector<FilterScope> filter_scopes;
+	std::unordered_map<string, idx_t> filter_scope_by_query;
+	yyjson_mut_val *bucket_metrics = nullptr;
+	// Set when a top_hits aggregation is sorted by _score, which needs the query to run in the scoring context.
+	bool sorts_by_score = false;
+
+	vector<ElasticsearchAggregateColumn> columns;
+
+	AggregateRequestBuilder(yyjson_mut_doc *doc_p, const ElasticsearchScanMatch &match_p,
+	                        const ElasticsearchSchema &schema_p)
+	    : doc(doc_p), match(match_p), schema(schema_p) {
+		sources = yyjson_mut_arr(doc);
+		metrics = yyjson_mut_obj(doc);
+	}
+
+	// Add a composite source named "g<i>" to the sources array.
+	void AddSource(yyjson_mut_val *source) {
+		string name = "g" + to_string(yyjson_mut_arr_size(sources));
+		yyjson_mut_val *named = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add(named, yyjson_mut_strcpy(doc, name.c_str()), source);
+		yyjson_mut_arr_append(sources, named);
+	}
+
+	// Add a metric sub-aggregation {"<type>": {"field": field}} and return its name.
+	string AddMetric(const char *type, const string &field) {
+		string name = "m" + to_string(metric_count++);
+		yyjson_mut_val *body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_strcpy(doc, body, "field", field.c_str());
+		if (strcmp(type, "geo_bounds") == 0) {
+			// Report the minimum and maximum longitude instead of a box wrapping around the antimeridian.
+			yyjson_mut_obj_add_bool(doc, body, "wrap_longitude", false);
+		}
+		yyjson_mut_val *metric = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, metric, type, body);
+		yyjson_mut_obj_add(metrics, yyjson_mut_strcpy(doc, name.c_str()), metric);
+		return name;
+	}
+
+	// Get the metric sub-aggregation of a type for a field, adding it on first use.
+	string GetSharedMetric(const char *type, const string &field) {
+		string key = string(type) + ":" + field;
+		auto it = shared_metrics.find(key);
+		if (it != shared_metrics.end()) {
+			return it->second;
+		}
+		string name = AddMetric(type, field);
+		shared_metrics[key] = name;
+		return name;
+	}
+
+	// Enter the filter sub-aggregation for a query, adding it on first use. Metrics added until LeaveFilter are
+	// computed on the documents of the bucket matching the query. Returns the name of the sub-aggregation.
+	string EnterFilter(yyjson_mut_val *query) {
+		char *json_str = yyjson_mut_val_write(query, 0, nullptr);
+		string key = json_str ? json_str : "";
+		free(json_str);
+
+		auto it = filter_scope_by_query.find(key);
+		if (it == filter_scope_by_query.end()) {
+			FilterScope scope;
+			scope.name = "f" + to_string(filter_scopes.size());
+			scope.metrics = yyjson_mut_obj(doc);
+			scope.aggregation = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, scope.aggregation, "filter", query);
+			yyjson_mut_obj_add(metrics, yyjson_mut_strcpy(doc, scope.name.c_str()), scope.aggregation);
+			it = filter_scope_by_query.emplace(key, filter_scopes.size()).first;
+			filter_scopes.push_back(std::move(scope));
+		}
+		auto &scope = filter_scopes[it->second];
+		bucket_metrics = metrics;
+		metrics = scope.metrics;
+		// The shared metrics of the bucket are kept in the scope until LeaveFilter.
+		std::swap(shared_metrics, scope.shared_metrics);
+		return scope.name;
+	}
+
+	// Leave the filter sub-aggregation entered with EnterFilter.
+	void LeaveFilter(const string &name) {
+		for (auto &scope : filter_scopes) {
+			if (scope.name != name) {
+				continue;
+			}
+			// An empty aggs object is rejected, filters only counting documents have none.
+			if (yyjson_mut_obj_size(scope.metrics) > 0 && !yyjson_mut_obj_get(scope.aggregation, "aggs")) {
+				yyjson_mut_obj_add_val(doc, scope.aggregation, "aggs", scope.metrics);
+			}
+			std::swap(shared_metrics, scope.shared_metrics);
+		}
+		metrics = bucket_metrics;
+		bucket_metrics = nullptr;
+	}
+
+	// Add a top_hits sub-aggregation returning the first size documents of the bucket in sort order (any
+	// documents without sort keys) with the given _source fields, or the full _source with full_source. With
+	// exists_fields, only documents having all of these fields are considered, through an enclosing filter
+	// aggregation. Returns the path of the hits array inside the bucket.
+	string AddTopHit(const vector<ElasticsearchSortKey> &sort, const vector<string> &source_fields, bool full_source,
+	                 const vector<string> &exists_fields, idx_t size = 1) {
+		string name = "m" + to_string(metric_count++);
+		yyjson_mut_val *body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_uint(doc, body, "size", size);
+		if (!sort.empty()) {
+			yyjson_mut_obj_add_val(doc, body, "sort", BuildElasticsearchSort(doc, sort));
+		}
+		for (auto &key : sort) {
+			sorts_by_score = sorts_by_score || key.field == "_score";
+		}
+		if (!full_source) {
+			yyjson_mut_val *source_arr = yyjson_mut_arr(doc);
+			for (const auto &field : source_fields) {
+				yyjson_mut_arr_add_strcpy(doc, source_arr, field.c_str());
+			}
+			yyjson_mut_obj_add_val(doc, body, "_source", source_arr);
+		}
+		yyjson_mut_val *top_hits = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, top_hits, "top_hits", body);
+		if (exists_fields.empty()) {
+			yyjson_mut_obj_add(metrics, yyjson_mut_strcpy(doc, name.c_str()), top_hits);
+			return name + ".hits.hits";
+		}
+
+		// {"filter": {"bool": {"filter": [{"exists": {"field": ...}}, ...]}}, "aggs": {"hit": {"top_hits": ...}}}
+		yyjson_mut_val *filters = yyjson_mut_arr(doc);
+		for (const auto &field : exists_fields) {
+			yyjson_mut_val *exists_body = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_strcpy(doc, exists_body, "field", field.c_str());
+			yyjson_mut_val *exists = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, exists, "exists", exists_body);
+			yyjson_mut_arr_append(filters, exists);
+		}
+		yyjson_mut_val *bool_body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, bool_body, "filter", filters);
+		yyjson_mut_val *filter_query = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, filter_query, "bool", bool_body);
+		yyjson_mut_val *sub_aggs = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, sub_aggs, "hit", top_hits);
+		yyjson_mut_val *filter_agg = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, filter_agg, "filter", filter_query);
+		yyjson_mut_obj_add_val(doc, filter_agg, "aggs", sub_aggs);
+		yyjson_mut_obj_add(metrics, yyjson_mut_strcpy(doc, name.c_str()), filter_agg);
+		return name + ".hit.hits.hits";
+	}
+};
+
+// Match a numeric bucketing expression: floor(x / w) * w, w * floor(x / w) or floor(x / w) with a constant
+// positive width w. These are exactly the keys of an Elasticsearch histogram with interval w, which computes
+// floor(x / w) * w in double precision. For floor(x / w) the key is divided by w when reading the bucket.
+static bool MatchHistogramGroup(const Expression &expr, const ElasticsearchScanMatch &match,
+                                const ElasticsearchSchema &schema, ElasticsearchFieldRef &field, double &interval,
+                                double &divisor) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+
+	// floor(x / w) * w or w * floor(x / w)
+	if (func_expr.function.name == "*" && func_expr.children.size() == 2) {
+		for (idx_t floor_idx = 0; floor_idx < 2; floor_idx++) {
+			double factor;
+			if (!ExtractConstantDouble(*func_expr.children[1 - floor_idx], factor)) {
+				continue;
+			}
+			double floor_divisor;
+			if (MatchHistogramGroup(*func_expr.children[floor_idx], match, schema, field, interval, floor_divisor) &&
+			    floor_divisor == interval && factor == interval) {
+				divisor = 1;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// floor(x / w)
+	if (func_expr.function.name != "floor" || func_expr.children.size() != 1) {
+		return false;
+	}
+	auto &div_arg = StripDoubleCast(*func_expr.children[0]);
+	if (div_arg.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &div_expr = div_arg.Cast<BoundFunctionExpression>();
+	if (div_expr.function.name != "/" || div_expr.children.size() != 2) {
+		return false;
+	}
+	if (!ExtractConstantDouble(*div_expr.children[1], interval) || !(interval > 0)) {
+		return false;
+	}
+	if (!ResolveElasticsearchField(StripDoubleCast(*div_expr.children[0]), match, field)) {
+		return false;
+	}
+	if (NUMERIC_ES_TYPES.count(field.es_type) == 0 || GetDocValueField(field, schema).empty()) {
+		return false;
+	}
+	divisor = interval;
+	return true;
+}
+
+// Resolve a geo_point field holding single points (a GEOMETRY column, not a list of points).
+static bool ResolveGeoPointField(const Expression &expr, const ElasticsearchScanMatch &match,
+                                 ElasticsearchFieldRef &field) {
+	return ResolveElasticsearchField(expr, match, field) && field.es_type == "geo_point" &&
+	       field.type.id() == LogicalTypeId::GEOMETRY;
+}
+
+// Match ST_GeoHash(point, precision) over a geo_point field with a constant precision between 1 and
+// MAX_GEOHASH_GRID_PRECISION. These are the keys of an Elasticsearch geohash_grid aggregation with the same precision.
+static bool MatchGeoHashGroup(const Expression &expr, const ElasticsearchScanMatch &match,
+                              ElasticsearchFieldRef &field, int64_t &precision) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	if (StringUtil::Lower(func_expr.function.name) != "st_geohash" || func_expr.children.size() != 2) {
+		return false;
+	}
+	double value;
+	if (!ExtractConstantDouble(*func_expr.children[1], value) || value < 1 || value > MAX_GEOHASH_GRID_PRECISION ||
+	    value != std::floor(value)) {
+		return false;
+	}
+	precision = static_cast<int64_t>(value);
+	return ResolveGeoPointField(*func_expr.children[0], match, field);
+}
+
+// Translate a GROUP BY expression into a composite source and its output column.
+static bool TranslateGroup(AggregateRequestBuilder &builder, const Expression &expr,
+                           ElasticsearchAggregateColumn &column) {
+	string key_path = "key.g" + to_string(yyjson_mut_arr_size(builder.sources));
+	yyjson_mut_doc *doc = builder.doc;
+
+	// Numeric bucketing -> histogram source.
+	ElasticsearchFieldRef field;
+	double interval, divisor;
+	if (MatchHistogramGroup(expr, builder.match, builder.schema, field, interval, divisor)) {
+		yyjson_mut_val *body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_strcpy(doc, body, "field", field.path.c_str());
+		yyjson_mut_obj_add_real(doc, body, "interval", interval);
+		yyjson_mut_obj_add_bool(doc, body, "missing_bucket", true);
+		yyjson_mut_val *source = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, source, "histogram", body);
+		builder.AddSource(source);
+
+		column.value_path = key_path;
+		column.divisor = divisor;
+		return true;
+	}
+
+	// ST_GeoHash(point, p) -> geohash_grid aggregation, which is not a composite source (see TranslateGroups).
+	int64_t precision;
+	if (MatchGeoHashGroup(expr, builder.match, field, precision)) {
+		builder.geohash_grid = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_strcpy(doc, builder.geohash_grid, "field", field.path.c_str());
+		yyjson_mut_obj_add_int(doc, builder.geohash_grid, "precision", precision);
+		column.value_path = "key";
+		return true;
+	}
+
+	// Plain field -> terms source. missing_bucket keeps documents without a value as the NULL group.
+	if (!ResolveElasticsearchField(expr, builder.match, field)) {
+		return false;
+	}
+	// Rounded doc values of half_float and scaled_float fields would merge groups.
+	string doc_value_field = GetDocValueField(field, builder.schema);
+	if (doc_value_field.empty() || field.es_type == "half_float" || field.es_type == "scaled_float") {
+		return false;
+	}
+	yyjson_mut_val *body = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, body, "field", doc_value_field.c_str());
+	yyjson_mut_obj_add_bool(doc, body, "missing_bucket", true);
+	yyjson_mut_val *source = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, source, "terms", body);
+	builder.AddSource(source);
+
+	column.value_path = key_path;
+	return true;
+}
+
+// Translate arg_max(arg, val) / arg_min(arg, val) (or max_by / min_by) into a top_hits sub-aggregation returning
+// the document with the largest (smallest) val. Like the SQL aggregate, only documents where both arg and val are
+// not NULL are considered. The output column reads arg from the _source of that document.
+static bool TranslateArgMinMax(AggregateRequestBuilder &builder, const BoundAggregateExpression &aggr,
+                               ElasticsearchAggregateColumn &column) {
+	if (aggr.children.size() != 2) {
+		return false;
+	}
+	// The top hits of a nested aggregation are nested documents, whose _source is not read like a document's.
+	ElasticsearchFieldRef arg;
+	if (builder.match.unnest ||
+	    !ResolveElasticsearchField(StripDoubleCast(*aggr.children[0]), builder.match, arg) || arg.es_type == "nested") {
+		return false;
+	}
+
+	const auto &name = aggr.function.name;
+	bool is_max = name == "arg_max" || name == "max_by";
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(is_max ? OrderType::DESCENDING : OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    StripDoubleCast(*aggr.children[1]).Copy());
+	// _score is not a field that the exists filter of the top hit could test.
+	vector<ElasticsearchSortKey> sort;
+	if (!TranslateSortKeys(orders, builder.match, sort) || sort[0].field == "_score") {
+		return false;
+	}
+
+	column.hits_path = builder.AddTopHit(sort, {arg.path}, false, {arg.path, sort[0].field});
+	column.value_path = arg.path;
+	column.es_type = arg.es_type;
+	return true;
+}
+
+// Translate min(field) / max(field) of a long field into a top_hits sub-aggregation returning the document with the
+// smallest (largest) value, read from its _source. Unlike stats, which are computed in double precision, the sort
+// compares the exact longs.
+static bool TranslateLongMinMax(AggregateRequestBuilder &builder, const Expression &expr, bool is_max,
+                                const ElasticsearchFieldRef &field, ElasticsearchAggregateColumn &column) {
+	// The top hits of a nested aggregation are nested documents, whose _source is not read like a document's.
+	if (builder.match.unnest) {
+		return false;
+	}
+	vector<BoundOrderByNode> orders;
+	orders.emplace_back(is_max ? OrderType::DESCENDING : OrderType::ASCENDING, OrderByNullType::NULLS_LAST,
+	                    expr.Copy());
+	vector<ElasticsearchSortKey> sort;
+	if (!TranslateSortKeys(orders, builder.match, sort)) {
+		return false;
+	}
+	column.hits_path = builder.AddTopHit(sort, {field.path}, false, {sort[0].field});
+	column.value_path = field.path;
+	column.es_type = field.es_type;
+	return true;
+}
+
+// Match ST_X(point) or ST_Y(point) over a geo_point field and get the coordinate name ("lon" or "lat").
+static bool MatchGeoPointCoordinate(const Expression &expr, const ElasticsearchScanMatch &match,
+                                    ElasticsearchFieldRef &field, string &coordinate) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	auto func_name = StringUtil::Lower(func_expr.function.name);
+	if ((func_name != "st_x" && func_name != "st_y") || func_expr.children.size() != 1) {
+		return false;
+	}
+	coordinate = func_name == "st_x" ? "lon" : "lat";
+	return ResolveGeoPointField(*func_expr.children[0], match, field);
+}
+
+// Translate avg/min/max of a geo_point coordinate: avg into geo_centroid, min/max into geo_bounds. Both are
+// computed from the indexed points, which Elasticsearch stores with a precision of about 1 cm.
+static bool TranslateGeoPointAggregate(AggregateRequestBuilder &builder, const string &name,
+                                       const ElasticsearchFieldRef &field, const string &coordinate,
+                                       ElasticsearchAggregateColumn &column) {
+	if (name == "avg") {
+		column.value_path = builder.GetSharedMetric("geo_centroid", field.path) + ".location." + coordinate;
+		return true;
+	}
+	if (name != "min" && name != "max") {
+		return false;
+	}
+	// The bounds are a box from top_left (min lon, max lat) to bottom_right (max lon, min lat).
+	bool top_left = (coordinate == "lon") == (name == "min");
+	column.value_path = builder.GetSharedMetric("geo_bounds", field.path) + ".bounds." +
+	                    (top_left ? "top_left." : "bottom_right.") + coordinate;
+	return true;
+}
+
+// Translate a predicate on a field into a query with the filter translation of the document scan.
+static yyjson_mut_val *TranslateFieldFilter(AggregateRequestBuilder &builder, const ElasticsearchFieldRef &field,
+                                            unique_ptr<TableFilter> filter) {
+	TableFilterSet filters;
+	filters.PushFilter(ProjectionIndex(0), std::move(filter));
+	return TranslateFilters(builder.doc, filters, {field.path}, builder.schema).es_query;
+}
+
+// Resolve the field side of a predicate. Values are compared on doc values (keyword subfields of text fields),
+// widening numeric casts compare the same values.
+static bool ResolveFilterField(AggregateRequestBuilder &builder, const Expression &expr, ElasticsearchFieldRef &field) {
+	return ResolveElasticsearchField(StripOrderPreservingCast(expr), builder.match, field) &&
+	       !GetDocValueField(field, builder.schema).empty();
+}
+
+static bool ExtractConstantValue(const Expression &expr, Value &value) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return false;
+	}
+	value = expr.Cast<BoundConstantExpression>().value;
+	return !value.IsNull();
+}
+
+// Translate the predicate of a FILTER (WHERE ...) clause into an Elasticsearch query, or nullptr. Unlike pushed
+// WHERE clauses, the predicate is not evaluated again by DuckDB, so it is only translated when every part of it
+// is: comparisons, BETWEEN, IN, IS [NOT] NULL and LIKE on fields, boolean fields and AND/OR of these.
+static yyjson_mut_val *TranslateAggregateFilter(AggregateRequestBuilder &builder, const Expression &expr) {
+	yyjson_mut_doc *doc = builder.doc;
+	ElasticsearchFieldRef field;
+	Value value;
+
+	switch (expr.GetExpressionClass()) {
+	case ExpressionClass::BOUND_CONJUNCTION: {
+		// AND -> {"bool": {"filter": [...]}}, OR -> {"bool": {"should": [...], "minimum_should_match": 1}}
+		auto &conj_expr = expr.Cast<BoundConjunctionExpression>();
+		bool is_and = expr.type == ExpressionType::CONJUNCTION_AND;
+		yyjson_mut_val *clauses = yyjson_mut_arr(doc);
+		for (auto &child : conj_expr.children) {
+			yyjson_mut_val *clause = TranslateAggregateFilter(builder, *child);
+			if (!clause) {
+				return nullptr;
+			}
+			yyjson_mut_arr_append(clauses, clause);
+		}
+		yyjson_mut_val *bool_body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, bool_body, is_and ? "filter" : "should", clauses);
+		if (!is_and) {
+			yyjson_mut_obj_add_int(doc, bool_body, "minimum_should_match", 1);
+		}
+		yyjson_mut_val *result = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, result, "bool", bool_body);
+		return result;
+	}
+	case ExpressionClass::BOUND_COLUMN_REF: {
+		// A boolean field: FILTER (WHERE deprecated).
+		if (!ResolveFilterField(builder, expr, field) || field.type.id() != LogicalTypeId::BOOLEAN) {
+			return nullptr;
+		}
+		return TranslateFieldFilter(builder, field,
+		                            make_uniq<ConstantFilter>(ExpressionType::COMPARE_EQUAL, Value::BOOLEAN(true)));
+	}
+	case ExpressionClass::BOUND_COMPARISON: {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		auto comparison_type = expr.type;
+		if (!ResolveFilterField(builder, *comp_expr.left, field) || !ExtractConstantValue(*comp_expr.right, value)) {
+			// constant op field
+			if (!ResolveFilterField(builder, *comp_expr.right, field) ||
+			    !ExtractConstantValue(*comp_expr.left, value)) {
+				return nullptr;
+			}
+			comparison_type = FlipComparisonExpression(comparison_type);
+		}
+		switch (comparison_type) {
+		case ExpressionType::COMPARE_EQUAL:
+		case ExpressionType::COMPARE_LESSTHAN:
+		case ExpressionType::COMPARE_GREATERTHAN:
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+		case ExpressionType::COMPARE_NOTEQUAL:
+			return TranslateFieldFilter(builder, field, make_uniq<ConstantFilter>(comparison_type, value));
+		default:
+			return nullptr;
+		}
+	}
+	case ExpressionClass::BOUND_BETWEEN: {
+		auto &between_expr = expr.Cast<BoundBetweenExpression>();
+		Value upper;
+		if (!ResolveFilterField(builder, *between_expr.input, field) ||
+		    !ExtractConstantValue(*between_expr.lower, value) || !ExtractConstantValue(*between_expr.upper, upper)) {
+			return nullptr;
+		}
+		auto conjunction = make_uniq<ConjunctionAndFilter>();
+		conjunction->child_filters.push_back(make_uniq<ConstantFilter>(
+		    between_expr.lower_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+		                                 : ExpressionType::COMPARE_GREATERTHAN,
+		    value));
+		conjunction->child_filters.push_back(make_uniq<ConstantFilter>(
+		    between_expr.upper_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO : ExpressionType::COMPARE_LESSTHAN,
+		    upper));
+		return TranslateFieldFilter(builder, field, std::move(conjunction));
+	}
+	case ExpressionClass::BOUND_OPERATOR: {
+		auto &op_expr = expr.Cast<BoundOperatorExpression>();
+		if (op_expr.children.empty()) {
+			return nullptr;
+		}
+		if (expr.type == ExpressionType::OPERATOR_IS_NULL || expr.type == ExpressionType::OPERATOR_IS_NOT_NULL) {
+			// exists also works on fields without doc values (text fields).
+			if (op_expr.children.size() != 1 ||
+			    !ResolveElasticsearchField(*op_expr.children[0], builder.match, field) || field.es_type == "nested") {
+				return nullptr;
+			}
+			if (expr.type == ExpressionType::OPERATOR_IS_NULL) {
+				return TranslateFieldFilter(builder, field, make_uniq<IsNullFilter>());
+			}
+			return TranslateFieldFilter(builder, field, make_uniq<IsNotNullFilter>());
+		}
+		if (expr.type != ExpressionType::COMPARE_IN || !ResolveFilterField(builder, *op_expr.children[0], field)) {
+			return nullptr;
+		}
+		vector<Value> values;
+		for (idx_t i = 1; i < op_expr.children.size(); i++) {
+			if (!ExtractConstantValue(*op_expr.children[i], value)) {
+				return nullptr;
+			}
+			values.push_back(value);
+		}
+		return TranslateFieldFilter(builder, field, make_uniq<InFilter>(std::move(values)));
+	}
+	case ExpressionClass::BOUND_FUNCTION: {
+		// LIKE / ILIKE and the prefix, suffix and contains functions of LIKE patterns.
+		auto &func_expr = expr.Cast<BoundFunctionExpression>();
+		static const std::unordered_set<string> PATTERN_FUNCTIONS = {"~~",     "like_escape", "~~*",
+		                                                             "ilike_escape", "prefix", "suffix",
+		                                                             "contains"};
+		if (!PATTERN_FUNCTIONS.count(func_expr.function.name) || func_expr.children.size() < 2 ||
+		    !ResolveFilterField(builder, *func_expr.children[0], field) ||
+		    !ExtractConstantValue(*func_expr.children[1], value) || value.type().id() != LogicalTypeId::VARCHAR) {
+			return nullptr;
+		}
+		return TranslateFieldFilter(builder, field, make_uniq<ExpressionFilter>(expr.Copy()));
+	}
+	default:
+		return nullptr;
+	}
+}
+
+// Translate an aggregate function into a bucket value and its output column.
+// Supports count(*), count(x), sum(x), min(x), max(x), avg(x), arg_max(x, y) and arg_min(x, y) without
+// DISTINCT or ORDER BY, and avg/min/max of ST_X/ST_Y over geo_point fields. An aggregate with a FILTER clause
+// is computed by the same metrics below a filter sub-aggregation.
+static bool TranslateAggregate(AggregateRequestBuilder &builder, const BoundAggregateExpression &aggr,
+                               ElasticsearchAggregateColumn &column) {
+	if (aggr.IsDistinct() || aggr.order_bys) {
+		return false;
+	}
+	if (aggr.filter) {
+		yyjson_mut_val *query = TranslateAggregateFilter(builder, *aggr.filter);
+		if (!query) {
+			return false;
+		}
+		auto unfiltered = aggr.Copy();
+		unfiltered->Cast<BoundAggregateExpression>().filter = nullptr;
+		string name = builder.EnterFilter(query);
+		bool success = TranslateAggregate(builder, unfiltered->Cast<BoundAggregateExpression>(), column);
+		builder.LeaveFilter(name);
+		if (!success) {
+			return false;
+		}
+		// Top hits columns read their value from the document, the other paths are relative to the bucket.
+		if (!column.hits_path.empty()) {
+			column.hits_path = name + "." + column.hits_path;
+			return true;
+		}
+		column.value_path = name + "." + column.value_path;
+		if (!column.null_if_zero_path.empty()) {
+			column.null_if_zero_path = name + "." + column.null_if_zero_path;
+		}
+		return true;
+	}
+
+	const auto &name = aggr.function.name;
+	if (name == "count_star" || (name == "count" && aggr.children.empty())) {
+		column.value_path = "doc_count";
+		return true;
+	}
+	if (name == "arg_max" || name == "arg_min" || name == "max_by" || name == "min_by") {
+		return TranslateArgMinMax(builder, aggr, column);
+	}
+	if (aggr.children.size() != 1) {
+		return false;
+	}
+
+	ElasticsearchFieldRef field;
+	string coordinate;
+	if (MatchGeoPointCoordinate(*aggr.children[0], builder.match, field, coordinate)) {
+		return TranslateGeoPointAggregate(builder, name, field, coordinate, column);
+	}
+	if (!ResolveElasticsearchField(StripDoubleCast(*aggr.children[0]), builder.match, field)) {
+		return false;
+	}
+	string doc_value_field = GetDocValueField(field, builder.schema);
+	if (doc_value_field.empty()) {
+		return false;
+	}
+
+	if (name == "count") {
+		column.value_path = builder.AddMetric("value_count", doc_value_field) + ".value";
+		return true;
+	}
+
+	bool is_numeric = NUMERIC_ES_TYPES.count(field.es_type) > 0;
+	bool is_date = field.es_type == "date";
+	if (name == "sum" || name == "avg") {
+		if (!is_numeric) {
+			return false;
+		}
+	} else if (name == "min" || name == "max") {
+		if (!is_numeric && !is_date) {
+			return false;
+		}
+	} else {
+		return false;
+	}
+	// Stats are computed in double precision, which rounds longs beyond 2^53. Sums and averages of longs are left
+	// to DuckDB, which computes them exactly.
+	if (field.es_type == "long") {
+		return name != "sum" && name != "avg" &&
+		       TranslateLongMinMax(builder, StripDoubleCast(*aggr.children[0]), name == "max", field, column);
+	}
+
+	// Stats are 0 (sum) or null for buckets without values, SQL aggregates are NULL.
+	string stats = builder.GetSharedMetric("stats", doc_value_field);
+	column.value_path = stats + "." + name;
+	column.null_if_zero_path = stats + ".count";
+	return true;
+}
+
+// Get the buckets_path of a bucket value for pipeline aggregations, or an empty string if it cannot be referenced.
+static string GetBucketsPath(const string &value_path) {
+	if (value_path == "doc_count") {
+		return "_count";
+	}
+	// Only single-value metrics and stats values (<name>.<value>) can be referenced, not geo coordinates.
+	if (std::count(value_path.begin(), value_path.end(), '.') > 1) {
+		return string();
+	}
+	// Single-value metrics (value_count) are referenced by the aggregation name.
+	if (StringUtil::EndsWith(value_path, ".value")) {
+		return value_path.substr(0, value_path.size() - 6);
+	}
+	return value_path;
+}
+
+// Translates HAVING predicates into a bucket_selector pipeline aggregation.
+// The script compares bucket values (params.v<k>, bound through buckets_path) with constants (params.c<k>).
+// Only buckets for which the script returns true are returned by Elasticsearch. The HAVING filter stays in the
+// plan, so the script only has to keep every bucket that may qualify: untranslatable AND terms are dropped and
+// comparisons on missing values (e.g. avg of a bucket without values) evaluate to false, like NULL in SQL.
+struct BucketSelectorBuilder {
+	yyjson_mut_doc *doc;
+	// Table index of the aggregate outputs and the bucket value path of each aggregate.
+	idx_t aggregate_index;
+	const vector<string> &aggregate_paths;
+
+	yyjson_mut_val *buckets_path;
+	yyjson_mut_val *params;
+	std::unordered_map<string, string> var_by_path;
+	idx_t const_count = 0;
+
+	BucketSelectorBuilder(yyjson_mut_doc *doc_p, idx_t aggregate_index_p, const vector<string> &aggregate_paths_p)
+	    : doc(doc_p), aggregate_index(aggregate_index_p), aggregate_paths(aggregate_paths_p) {
+		buckets_path = yyjson_mut_obj(doc);
+		params = yyjson_mut_obj(doc);
+	}
+
+	// Translate an operand into a script expression. Variables are collected for the null checks.
+	bool TranslateOperand(const Expression &expr, string &script, vector<string> &vars) {
+		auto &operand = StripOrderPreservingCast(expr);
+		if (operand.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+			auto &binding = operand.Cast<BoundColumnRefExpression>().binding;
+			if (binding.table_index != aggregate_index) {
+				return false;
+			}
+			auto aggregate_idx = binding.column_index.GetIndexUnsafe();
+			if (aggregate_idx >= aggregate_paths.size() || aggregate_paths[aggregate_idx].empty()) {
+				return false;
+			}
+			string path = GetBucketsPath(aggregate_paths[aggregate_idx]);
+			if (path.empty()) {
+				return false;
+			}
+			auto it = var_by_path.find(path);
+			if (it == var_by_path.end()) {
+				string var = "v" + to_string(var_by_path.size());
+				yyjson_mut_obj_add(buckets_path, yyjson_mut_strcpy(doc, var.c_str()), yyjson_mut_strcpy(doc, path.c_str()));
+				it = var_by_path.emplace(path, var).first;
+			}
+			script = "params." + it->second;
+			vars.push_back(script);
+			return true;
+		}
+
+		double value;
+		if (ExtractConstantDouble(operand, value)) {
+			string name = "c" + to_string(const_count++);
+			yyjson_mut_obj_add(params, yyjson_mut_strcpy(doc, name.c_str()), yyjson_mut_real(doc, value));
+			script = "params." + name;
+			return true;
+		}
+		return false;
+	}
+
+	// Wrap a comparison so that it is false when any of its variables is missing.
+	static string GuardComparison(const string &comparison, const vector<string> &vars) {
+		string result = "(";
+		for (auto &var : vars) {
+			result += var + " != null && ";
+		}
+		return result + comparison + ")";
+	}
+
+	bool TranslatePredicate(const Expression &expr, string &script) {
+		switch (expr.GetExpressionClass()) {
+		case ExpressionClass::BOUND_COMPARISON: {
+			auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+			string op;
+			switch (expr.type) {
+			case ExpressionType::COMPARE_EQUAL:
+				op = " == ";
+				break;
+			case ExpressionType::COMPARE_NOTEQUAL:
+				op = " != ";
+				break;
+			case ExpressionType::COMPARE_LESSTHAN:
+				op = " < ";
+				break;
+			case ExpressionType::COMPARE_GREATERTHAN:
+				op = " > ";
+				break;
+			case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+				op = " <= ";
+				break;
+			case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+				op = " >= ";
+				break;
+			default:
+				return false;
+			}
+			string left, right;
+			vector<string> vars;
+			if (!TranslateOperand(*comp_expr.left, left, vars) || !TranslateOperand(*comp_expr.right, right, vars) ||
+			    vars.empty()) {
+				return false;
+			}
+			script = GuardComparison(left + op + right, vars);
+			return true;
+		}
+		case ExpressionClass::BOUND_BETWEEN: {
+			auto &between_expr = expr.Cast<BoundBetweenExpression>();
+			string input, lower, upper;
+			vector<string> vars;
+			if (!TranslateOperand(*between_expr.input, input, vars) ||
+			    !TranslateOperand(*between_expr.lower, lower, vars) ||
+			    !TranslateOperand(*between_expr.upper, upper, vars) || vars.empty()) {
+				return false;
+			}
+			string comparison = input + (between_expr.lower_inclusive ? " >= " : " > ") + lower + " && " + input +
+			                    (between_expr.upper_inclusive ? " <= " : " < ") + upper;
+			script = GuardComparison(comparison, vars);
+			return true;
+		}
+		case ExpressionClass::BOUND_CONJUNCTION: {
+			auto &conj_expr = expr.Cast<BoundConjunctionExpression>();
+			bool is_and = expr.type == ExpressionType::CONJUNCTION_AND;
+			vector<string> terms;
+			for (auto &child : conj_expr.children) {
+				string term;
+				if (TranslatePredicate(*child, term)) {
+					terms.push_back(term);
+				} else if (!is_and) {
+					// An OR is only as selective as all of its terms.
+					return false;
+				}
+			}
+			if (terms.empty()) {
+				return false;
+			}
+			script = "(" + StringUtil::Join(terms, is_and ? " && " : " || ") + ")";
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+};
+
+// Build a bucket_selector for the HAVING predicates above an aggregate, or nullptr if none can be translated.
+static yyjson_mut_val *BuildBucketSelector(yyjson_mut_doc *doc, const LogicalAggregate &aggregate,
+                                           const vector<string> &aggregate_paths, const LogicalFilter &having) {
+	BucketSelectorBuilder selector(doc, aggregate.aggregate_index, aggregate_paths);
+	vector<string> terms;
+	for (auto &expr : having.expressions) {
+		string term;
+		if (selector.TranslatePredicate(*expr, term)) {
+			terms.push_back(term);
+		}
+	}
+	if (terms.empty()) {
+		return nullptr;
+	}
+
+	yyjson_mut_val *script = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, script, "source", StringUtil::Join(terms, " && ").c_str());
+	yyjson_mut_obj_add_val(doc, script, "params", selector.params);
+	yyjson_mut_val *body = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, body, "buckets_path", selector.buckets_path);
+	yyjson_mut_obj_add_val(doc, body, "script", script);
+	yyjson_mut_val *bucket_selector = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, bucket_selector, "bucket_selector", body);
+	return bucket_selector;
+}
+
+// Match the scan below an aggregate or DISTINCT. The operator must sit directly on the scan (a remaining FILTER
+// means filters were not fully pushed) and the scan must not have a pushed limit.
+static bool MatchAggregateInput(LogicalOperator &op, ElasticsearchScanMatch &match) {
+	if (!MatchElasticsearchScan(op, match)) {
+		return false;
+	}
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	return bind_data.limit < 0 && bind_data.offset == 0;
+}
+
+// Match PROJECTION* -> UNNEST(nested field) -> scan below an aggregate, where the aggregate is computed over the
+// nested documents. A remaining FILTER on the unnested rows is not matched, as for the scan.
+static bool MatchNestedAggregateInput(LogicalOperator &op, ElasticsearchScanMatch &match) {
+	reference<LogicalOperator> current = op;
+	while (current.get().type == LogicalOperatorType::LOGICAL_PROJECTION && !current.get().children.empty()) {
+		match.projections.push_back(current.get().Cast<LogicalProjection>());
+		current = *current.get().children[0];
+	}
+	if (current.get().type != LogicalOperatorType::LOGICAL_UNNEST || current.get().children.size() != 1) {
+		return false;
+	}
+	auto &unnest = current.get().Cast<LogicalUnnest>();
+	if (unnest.expressions.size() != 1 || unnest.expressions[0]->GetExpressionClass() != ExpressionClass::BOUND_UNNEST ||
+	    !MatchAggregateInput(*unnest.children[0], match)) {
+		return false;
+	}
+
+	// The unnested list must be a nested field of the scan (a LIST(STRUCT) column).
+	auto list = unnest.expressions[0]->Cast<BoundUnnestExpression>().child->Copy();
+	ElasticsearchFieldRef field;
+	if (!InlineProjections(list, match) || !ResolveElasticsearchField(*list, match, field) ||
+	    field.es_type != "nested" || field.type.id() != LogicalTypeId::LIST) {
+		return false;
+	}
+	match.unnest = &unnest;
+	match.nested_path = field.path;
+	return true;
+}
+
+// Translate the GROUP BY expressions (or DISTINCT targets) into composite sources and output columns.
+static bool TranslateGroups(AggregateRequestBuilder &builder, const vector<unique_ptr<Expression>> &groups) {
+	for (auto &group : groups) {
+		auto expr = group->Copy();
+		ElasticsearchAggregateColumn column;
+		if (!InlineProjections(expr, builder.match) || !TranslateGroup(builder, *expr, column)) {
+			return false;
+		}
+		column.name = group->GetName();
+		column.type = group->return_type;
+		builder.columns.push_back(std::move(column));
+	}
+	// A geohash_grid aggregation has a single key.
+	return !builder.geohash_grid || groups.size() == 1;
+}
+
+// Create the elasticsearch_aggregate scan for the translated sources and metrics. The scan outputs the columns
+// of the builder in order. Without sources (an aggregate without GROUP BY) the metrics are computed over all
+// matching documents in a single row. Over an UNNEST of a nested field, buckets and metrics are computed on the
+// nested documents below a nested aggregation.
+static unique_ptr<LogicalOperator> CreateAggregateScan(Binder &binder, AggregateRequestBuilder &builder,
+                                                       bool filtered_buckets) {
+	auto &match = builder.match;
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	yyjson_mut_doc *doc = builder.doc;
+	bool global = !builder.geohash_grid && yyjson_mut_arr_size(builder.sources) == 0;
+	bool nested = match.unnest != nullptr;
+
+	// Build the request: {"query": ..., "aggs": {"groups": {"composite": {...}, "aggs": {...}}}}, or a
+	// geohash_grid named "groups" next to a missing aggregation. Without sources "groups" is a single bucket:
+	// a match_all filter, or the nested aggregation itself. Over nested documents the composite aggregation is
+	// below the nested aggregation: {"groups": {"nested": {"path": ...}, "aggs": {"groups": {"composite": ...}}}}.
+	vector<idx_t> column_ids;
+	for (auto &column_index : match.get->GetColumnIds()) {
+		column_ids.push_back(column_index.GetPrimaryIndex());
+	}
+	yyjson_mut_val *root = yyjson_mut_obj(doc);
+	yyjson_mut_doc_set_root(doc, root);
+	yyjson_mut_obj_add_val(doc, root, "query",
+	                       BuildElasticsearchQueryClause(doc, bind_data, &match.get->table_filters, column_ids,
+	                                                     builder.sorts_by_score));
+
+	yyjson_mut_val *groups = yyjson_mut_obj(doc);
+	yyjson_mut_val *aggs = yyjson_mut_obj(doc);
+	yyjson_mut_val *nested_body = nullptr;
+	if (nested) {
+		nested_body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_strcpy(doc, nested_body, "path", match.nested_path.c_str());
+	}
+
+	yyjson_mut_val *bucket_aggs = aggs;
+	if (nested && !global) {
+		bucket_aggs = yyjson_mut_obj(doc);
+		yyjson_mut_val *nested_agg = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, nested_agg, "nested", nested_body);
+		yyjson_mut_obj_add_val(doc, nested_agg, "aggs", bucket_aggs);
+		yyjson_mut_obj_add_val(doc, aggs, "groups", nested_agg);
+	}
+
+	if (builder.geohash_grid) {
+		// A geohash_grid returns all buckets in one request, with shard_size = size: when fewer buckets than size
+		// are returned, every shard returned all of its buckets.
+		yyjson_mut_val *field = yyjson_mut_obj_get(builder.geohash_grid, "field");
+		yyjson_mut_obj_add_uint(doc, builder.geohash_grid, "size", ALL_BUCKETS_SIZE);
+		yyjson_mut_obj_add_uint(doc, builder.geohash_grid, "shard_size", ALL_BUCKETS_SIZE);
+		yyjson_mut_obj_add_val(doc, groups, "geohash_grid", builder.geohash_grid);
+
+		// Documents without a value are not part of any bucket, a missing aggregation collects them.
+		yyjson_mut_val *missing_body = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, missing_body, "field", yyjson_mut_val_mut_copy(doc, field));
+		yyjson_mut_val *missing = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, missing, "missing", missing_body);
+		if (yyjson_mut_obj_size(builder.metrics) > 0) {
+			yyjson_mut_obj_add_val(doc, missing, "aggs", yyjson_mut_val_mut_copy(doc, builder.metrics));
+		}
+		yyjson_mut_obj_add_val(doc, bucket_aggs, "missing", missing);
+	} else if (global && nested) {
+		yyjson_mut_obj_add_val(doc, groups, "nested", nested_body);
+	} else if (global) {
+		yyjson_mut_val *match_all = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, match_all, "match_all", yyjson_mut_obj(doc));
+		yyjson_mut_obj_add_val(doc, groups, "filter", match_all);
+	} else {
+		yyjson_mut_val *composite = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_int(doc, composite, "size", bind_data.batch_size);
+		yyjson_mut_obj_add_val(doc, composite, "sources", builder.sources);
+		yyjson_mut_obj_add_val(doc, groups, "composite", composite);
+	}
+	if (yyjson_mut_obj_size(builder.metrics) > 0) {
+		yyjson_mut_obj_add_val(doc, groups, "aggs", builder.metrics);
+	}
+	yyjson_mut_obj_add_val(doc, bucket_aggs, "groups", groups);
+	yyjson_mut_obj_add_val(doc, root, "aggs", aggs);
+
+	auto aggregate_bind_data = make_uniq<ElasticsearchAggregateBindData>();
+	aggregate_bind_data->config = bind_data.config;
+	aggregate_bind_data->index = bind_data.index;
+	aggregate_bind_data->logger = bind_data.logger;
+	aggregate_bind_data->generated = true;
+	if (global) {
+		// The single bucket is read from the aggregations object of the response.
+		aggregate_bind_data->mode = ElasticsearchAggregateMode::SINGLE;
+		for (auto &column : builder.columns) {
+			column.level = 0;
+			if (!column.hits_path.empty()) {
+				column.hits_path = "groups." + column.hits_path;
+				continue;
+			}
+			column.value_path = "groups." + column.value_path;
+			if (!column.null_if_zero_path.empty()) {
+				column.null_if_zero_path = "groups." + column.null_if_zero_path;
+			}
+		}
+	} else if (builder.geohash_grid) {
+		aggregate_bind_data->levels = {"groups"};
+		aggregate_bind_data->mode = ElasticsearchAggregateMode::ALL_BUCKETS;
+		aggregate_bind_data->page_size = ALL_BUCKETS_SIZE;
+	} else {
+		aggregate_bind_data->levels = {nested ? "groups.groups" : "groups"};
+		aggregate_bind_data->composite_path = {"aggs", "groups"};
+		if (nested) {
+			aggregate_bind_data->composite_path.insert(aggregate_bind_data->composite_path.end(), {"aggs", "groups"});
+		}
+		aggregate_bind_data->mode = ElasticsearchAggregateMode::COMPOSITE;
+		aggregate_bind_data->page_size = static_cast<idx_t>(bind_data.batch_size);
+	}
+	aggregate_bind_data->filtered_buckets = filtered_buckets;
+	aggregate_bind_data->mapped_paths = bind_data.schema.all_mapped_paths;
+	char *json_str = yyjson_mut_write(doc, 0, nullptr);
+	if (json_str) {
+		aggregate_bind_data->request = json_str;
+		free(json_str);
+	}
+
+	vector<LogicalType> return_types;
+	vector<string> names;
+	for (auto &column : builder.columns) {
+		return_types.push_back(column.type);
+		names.push_back(column.name);
+	}
+	aggregate_bind_data->columns = std::move(builder.columns);
+
+	auto table_index = binder.GenerateTableIndex();
+	auto get = make_uniq<LogicalGet>(table_index, GetElasticsearchAggregateFunction(), std::move(aggregate_bind_data),
+	                                 std::move(return_types), std::move(names));
+	for (idx_t i = 0; i < get->returned_types.size(); i++) {
+		get->AddColumnId(i);
+	}
+	return std::move(get);
+}
+
+// Try to replace an aggregate above an elasticsearch_query scan with an elasticsearch_aggregate scan.
+// When the aggregate is below a HAVING filter, its predicates are pushed as a bucket_selector.
+// Returns the replacement scan or nullptr if the aggregate cannot be pushed down.
+static unique_ptr<LogicalOperator> TryPushdownAggregate(Binder &binder, LogicalAggregate &aggregate,
+                                                        optional_ptr<LogicalFilter> having) {
+	// Only plain GROUP BY: no GROUPING SETS / ROLLUP / CUBE or GROUPING(). Aggregates without GROUP BY are only
+	// pushed with FILTER clauses (conditional counters), which the document scan cannot push, or over the nested
+	// documents of an UNNEST, which the document scan cannot count.
+	if (aggregate.grouping_sets.size() > 1 || !aggregate.grouping_functions.empty()) {
+		return nullptr;
+	}
+	ElasticsearchScanMatch match;
+	if (!MatchAggregateInput(*aggregate.children[0], match)) {
+		match = ElasticsearchScanMatch();
+		if (!MatchNestedAggregateInput(*aggregate.children[0], match)) {
+			return nullptr;
+		}
+	}
+	if (aggregate.groups.empty() && !match.unnest) {
+		bool has_filter = false;
+		for (auto &expr : aggregate.expressions) {
+			if (expr->GetExpressionClass() == ExpressionClass::BOUND_AGGREGATE &&
+			    expr->Cast<BoundAggregateExpression>().filter) {
+				has_filter = true;
+			}
+		}
+		if (!has_filter) {
+			return nullptr;
+		}
+	}
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	AggregateRequestBuilder builder(doc, match, bind_data.schema);
+	vector<string> aggregate_paths;
+
+	// Nested documents are grouped by a composite aggregation below the nested aggregation, not by a geohash_grid.
+	bool success = TranslateGroups(builder, aggregate.groups) && !(match.unnest && builder.geohash_grid);
+	for (idx_t i = 0; success && i < aggregate.expressions.size(); i++) {
+		auto &expr = aggregate.expressions[i];
+		if (expr->GetExpressionClass() != ExpressionClass::BOUND_AGGREGATE) {
+			success = false;
+			break;
+		}
+		auto aggr_copy = expr->Copy();
+		auto &aggr = aggr_copy->Cast<BoundAggregateExpression>();
+		for (auto &child : aggr.children) {
+			if (!InlineProjections(child, match)) {
+				success = false;
+			}
+		}
+		if (aggr.filter && !InlineProjections(aggr.filter, match)) {
+			success = false;
+		}
+		ElasticsearchAggregateColumn column;
+		if (!success || !TranslateAggregate(builder, aggr, column)) {
+			success = false;
+			break;
+		}
+		column.name = expr->GetName();
+		column.type = expr->return_type;
+		// Top hits are documents, not bucket values a bucket_selector can compare. Values of filter
+		// sub-aggregations are not referenced either.
+		aggregate_paths.push_back(column.hits_path.empty() && !aggr.filter ? column.value_path : string());
+		builder.columns.push_back(std::move(column));
+	}
+	if (!success) {
+		yyjson_mut_doc_free(doc);
+		return nullptr;
+	}
+
+	// HAVING predicates on the aggregates are pushed as a bucket_selector next to the metrics. Not for grid
+	// aggregations, whose response must show whether all buckets were returned, nor without buckets.
+	yyjson_mut_val *bucket_selector = having && !builder.geohash_grid && !aggregate.groups.empty()
+	                                      ? BuildBucketSelector(doc, aggregate, aggregate_paths, *having)
+	                                      : nullptr;
+	if (bucket_selector) {
+		yyjson_mut_obj_add_val(doc, builder.metrics, "having", bucket_selector);
+	}
+
+	auto result = CreateAggregateScan(binder, builder, bucket_selector != nullptr);
+	yyjson_mut_doc_free(doc);
+	return result;
+}
+
+// Translate an output column of the operator below a rewritten DISTINCT ON or window into a column read from
+// a top hit: _id, _unmapped_ (which needs the full _source) or a field added to the _source fields.
+static bool TranslateHitColumn(const ElasticsearchScanMatch &match, const LogicalType &type,
+                               const ColumnBinding &binding, ElasticsearchAggregateColumn &column,
+                               vector<string> &source_fields, bool &full_source) {
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	unique_ptr<Expression> expr = make_uniq<BoundColumnRefExpression>(type, binding);
+	column.name = expr->GetName();
+	column.type = type;
+	idx_t col_id;
+	ElasticsearchFieldRef field;
+	if (!InlineProjections(expr, match)) {
+		return false;
+	} else if (ResolveElasticsearchColumnId(*expr, match, col_id) && col_id == 0) {
+		column.value_path = "_id";
+	} else if (ResolveElasticsearchColumnId(*expr, match, col_id) &&
+	           col_id == bind_data.schema.field_paths.size() + 1) {
+		// Unmapped fields are only found in the full _source.
+		column.value_path = "_unmapped_";
+		full_source = true;
+	} else if (ResolveElasticsearchField(*expr, match, field)) {
+		column.value_path = field.path;
+		column.es_type = field.es_type;
+		source_fields.push_back(field.path);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+// Try to replace DISTINCT ON (keys) above an elasticsearch_query scan with an elasticsearch_aggregate scan over a
+// composite aggregation on the keys with a top_hits sub-aggregation returning one document per bucket. ORDER BY
+// keys other than the DISTINCT ON keys sort the top hits, so each bucket returns the first row of its group.
+// The key columns are read from the bucket key, the other columns from the top hit.
+static unique_ptr<LogicalOperator> TryPushdownDistinctOn(Binder &binder, LogicalDistinct &distinct) {
+	ElasticsearchScanMatch match;
+	if (!MatchAggregateInput(*distinct.children[0], match)) {
+		return nullptr;
+	}
+	auto &child = *distinct.children[0];
+	child.ResolveOperatorTypes();
+	auto child_bindings = child.GetColumnBindings();
+
+	// Within a group the DISTINCT ON keys are constant, the remaining ORDER BY keys choose its first row.
+	vector<BoundOrderByNode> hit_orders;
+	if (distinct.order_by) {
+		for (auto &order : distinct.order_by->orders) {
+			bool is_target = false;
+			for (auto &target : distinct.distinct_targets) {
+				is_target = is_target || order.expression->Equals(*target);
+			}
+			if (!is_target) {
+				hit_orders.push_back(order.Copy());
+			}
+		}
+	}
+	vector<ElasticsearchSortKey> sort;
+	if (!hit_orders.empty() && !TranslateSortKeys(hit_orders, match, sort)) {
+		return nullptr;
+	}
+
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	AggregateRequestBuilder builder(doc, match, bind_data.schema);
+	if (!TranslateGroups(builder, distinct.distinct_targets)) {
+		yyjson_mut_doc_free(doc);
+		return nullptr;
+	}
+
+	// DISTINCT ON outputs the columns of its child.
+	vector<ElasticsearchAggregateColumn> columns;
+	vector<idx_t> hit_columns;
+	vector<string> source_fields;
+	bool full_source = false;
+	for (idx_t i = 0; i < child_bindings.size(); i++) {
+		idx_t target_idx = DConstants::INVALID_INDEX;
+		for (idx_t j = 0; j < distinct.distinct_targets.size(); j++) {
+			auto &target = *distinct.distinct_targets[j];
+			if (target.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF &&
+			    target.Cast<BoundColumnRefExpression>().binding == child_bindings[i]) {
+				target_idx = j;
+				break;
+			}
+		}
+		if (target_idx != DConstants::INVALID_INDEX) {
+			columns.push_back(builder.columns[target_idx]);
+			continue;
+		}
+
+		ElasticsearchAggregateColumn column;
+		if (!TranslateHitColumn(match, child.types[i], child_bindings[i], column, source_fields, full_source)) {
+			yyjson_mut_doc_free(doc);
+			return nullptr;
+		}
+		hit_columns.push_back(columns.size());
+		columns.push_back(std::move(column));
+	}
+	if (!hit_columns.empty()) {
+		string hits_path = builder.AddTopHit(sort, source_fields, full_source, {});
+		for (auto column_idx : hit_columns) {
+			columns[column_idx].hits_path = hits_path;
+		}
+	}
+	builder.columns = std::move(columns);
+
+	auto result = CreateAggregateScan(binder, builder, false);
+	yyjson_mut_doc_free(doc);
+	return result;
+}
+
+// Try to replace SELECT DISTINCT above an elasticsearch_query scan with an elasticsearch_aggregate scan that
+// reads the keys of a composite aggregation over the distinct columns.
+static unique_ptr<LogicalOperator> TryPushdownDistinct(Binder &binder, LogicalDistinct &distinct) {
+	if (distinct.distinct_type == DistinctType::DISTINCT_ON) {
+		return TryPushdownDistinctOn(binder, distinct);
+	}
+	if (distinct.order_by) {
+		return nullptr;
+	}
+	ElasticsearchScanMatch match;
+	if (!MatchAggregateInput(*distinct.children[0], match)) {
+		return nullptr;
+	}
+
+	// DISTINCT outputs the columns of its child. The targets must be exactly those columns, in order, so the
+	// replacement scan outputs the same columns.
+	auto child_bindings = distinct.children[0]->GetColumnBindings();
+	if (distinct.distinct_targets.size() != child_bindings.size()) {
+		return nullptr;
+	}
+	for (idx_t i = 0; i < child_bindings.size(); i++) {
+		auto &target = *distinct.distinct_targets[i];
+		if (target.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF ||
+		    !(target.Cast<BoundColumnRefExpression>().binding == child_bindings[i])) {
+			return nullptr;
+		}
+	}
+
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	AggregateRequestBuilder builder(doc, match, bind_data.schema);
+	if (!TranslateGroups(builder, distinct.distinct_targets)) {
+		yyjson_mut_doc_free(doc);
+		return nullptr;
+	}
+
+	auto result = CreateAggregateScan(binder, builder, false);
+	yyjson_mut_doc_free(doc);
+	return result;
+}
+
+// Match a QUALIFY predicate bounding row_number(): rn <= k, rn < k + 1 or rn = k (also with the constant on the
+// left side). The first k rows of each partition are enough to evaluate it.
+static bool MatchRowNumberLimit(const Expression &expr, const ColumnBinding &row_number, idx_t &limit) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+		return false;
+	}
+	auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+	auto comparison_type = expr.type;
+	const Expression *column = comp_expr.left.get();
+	const Expression *constant = comp_expr.right.get();
+	if (constant->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		std::swap(column, constant);
+		comparison_type = FlipComparisonExpression(comparison_type);
+	}
+	Value value;
+	if (column->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF ||
+	    !(column->Cast<BoundColumnRefExpression>().binding == row_number) || !ExtractConstantValue(*constant, value) ||
+	    !value.type().IsIntegral() || !value.DefaultTryCastAs(LogicalType::BIGINT)) {
+		return false;
+	}
+	auto k = value.GetValue<int64_t>();
+	if (comparison_type == ExpressionType::COMPARE_LESSTHAN) {
+		k--;
+	} else if (comparison_type != ExpressionType::COMPARE_LESSTHANOREQUALTO &&
+	           comparison_type != ExpressionType::COMPARE_EQUAL) {
+		return false;
+	}
+	if (k < 1) {
+		return false;
+	}
+	limit = static_cast<idx_t>(k);
+	return true;
+}
+
+// Try to replace the input of a QUALIFY row_number() OVER (PARTITION BY keys ORDER BY sort) <= k window with an
+// elasticsearch_aggregate scan over a composite aggregation on the keys with a top_hits sub-aggregation returning
+// the first k documents of each bucket in the same sort order. The window and the QUALIFY filter stay in the plan
+// and number the few returned rows. Returns the replacement for the window input or nullptr.
+static unique_ptr<LogicalOperator> TryPushdownTopHitsPerGroup(Binder &binder, LogicalFilter &filter,
+                                                              LogicalWindow &window) {
+	// Other window functions would be computed over the remaining rows only.
+	if (window.expressions.size() != 1 || window.expressions[0]->type != ExpressionType::WINDOW_ROW_NUMBER) {
+		return nullptr;
+	}
+	auto &row_number = window.expressions[0]->Cast<BoundWindowExpression>();
+	if (row_number.partitions.empty() || row_number.orders.empty() || row_number.filter_expr ||
+	    !row_number.arg_orders.empty()) {
+		return nullptr;
+	}
+	idx_t k = 0;
+	auto row_number_binding = window.GetColumnBindings().back();
+	for (auto &expr : filter.expressions) {
+		idx_t limit;
+		if (MatchRowNumberLimit(*expr, row_number_binding, limit)) {
+			k = k == 0 ? limit : MinValue(k, limit);
+		}
+	}
+	if (k == 0 || k > MAX_TOP_HITS_SIZE) {
+		return nullptr;
+	}
+
+	ElasticsearchScanMatch match;
+	if (!MatchAggregateInput(*window.children[0], match)) {
+		return nullptr;
+	}
+	vector<ElasticsearchSortKey> sort;
+	if (!TranslateSortKeys(row_number.orders, match, sort)) {
+		return nullptr;
+	}
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	AggregateRequestBuilder builder(doc, match, bind_data.schema);
+	if (!TranslateGroups(builder, row_number.partitions) || builder.geohash_grid) {
+		yyjson_mut_doc_free(doc);
+		return nullptr;
+	}
+
+	// The scan outputs the columns of the window input, all read from the hits.
+	auto &child = *window.children[0];
+	child.ResolveOperatorTypes();
+	auto child_bindings = child.GetColumnBindings();
+	vector<ElasticsearchAggregateColumn> columns;
+	vector<string> source_fields;
+	bool full_source = false;
+	for (idx_t i = 0; i < child_bindings.size(); i++) {
+		ElasticsearchAggregateColumn column;
+		if (!TranslateHitColumn(match, child.types[i], child_bindings[i], column, source_fields, full_source)) {
+			yyjson_mut_doc_free(doc);
+			return nullptr;
+		}
+		columns.push_back(std::move(column));
+	}
+	string hits_path = builder.AddTopHit(sort, source_fields, full_source, {}, k);
+	for (auto &column : columns) {
+		column.level = 2;
+		column.hits_path = ".";
+	}
+	builder.columns = std::move(columns);
+
+	auto result = CreateAggregateScan(binder, builder, false);
+	yyjson_mut_doc_free(doc);
+	// Each hit of a bucket is a row.
+	result->Cast<LogicalGet>().bind_data->Cast<ElasticsearchAggregateBindData>().levels.push_back(hits_path);
+	return result;
+}
+
+// Replace op with the replacement scan, which outputs the columns of op in the same order. Parent operators
+// reference the output bindings of op, which are rewritten to the bindings of the scan starting from the root.
+static void ReplaceWithScan(unique_ptr<LogicalOperator> &root, unique_ptr<LogicalOperator> &op,
+                            unique_ptr<LogicalOperator> replacement) {
+	auto old_bindings = op->GetColumnBindings();
+	auto new_bindings = replacement->GetColumnBindings();
+	ColumnBindingReplacer replacer;
+	for (idx_t i = 0; i < old_bindings.size() && i < new_bindings.size(); i++) {
+		replacer.replacement_bindings.emplace_back(old_bindings[i], new_bindings[i]);
+	}
+
+	op = std::move(replacement);
+	replacer.VisitOperator(*root);
+}
+
+// Walks the plan bottom-up and replaces pushable aggregates, DISTINCTs and the input of QUALIFY row_number()
+// windows. A FILTER directly above an aggregate is a HAVING clause and is passed down with the aggregate.
+static void PushdownAggregates(Binder &binder, unique_ptr<LogicalOperator> &root, unique_ptr<LogicalOperator> &op,
+                               optional_ptr<LogicalFilter> having = nullptr) {
+	bool is_having = op->type == LogicalOperatorType::LOGICAL_FILTER && op->children.size() == 1 &&
+	                 op->children[0]->type == LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY;
+	for (auto &child : op->children) {
+		PushdownAggregates(binder, root, child, is_having ? &op->Cast<LogicalFilter>() : nullptr);
+	}
+
+	// A QUALIFY filter on row_number() only needs the top rows of each partition from the window input.
+	if (op->type == LogicalOperatorType::LOGICAL_FILTER && op->children.size() == 1 &&
+	    op->children[0]->type == LogicalOperatorType::LOGICAL_WINDOW) {
+		auto &window = op->children[0];
+		auto replacement = TryPushdownTopHitsPerGroup(binder, op->Cast<LogicalFilter>(), window->Cast<LogicalWindow>());
+		if (replacement) {
+			ReplaceWithScan(root, window->children[0], std::move(replacement));
+		}
+		return;
+	}
+
+	// The aggregate outputs groups followed by aggregates (DISTINCT outputs its targets), the replacement scan
+	// outputs its columns in the same order.
+	unique_ptr<LogicalOperator> replacement;
+	if (op->type == LogicalOperatorType::LOGICAL_AGGREGATE_AND_GROUP_BY) {
+		replacement = TryPushdownAggregate(binder, op->Cast<LogicalAggregate>(), having);
+	} else if (op->type == LogicalOperatorType::LOGICAL_DISTINCT) {
+		replacement = TryPushdownDistinct(binder, op->Cast<LogicalDistinct>());
+	}
+	if (replacement) {
+		ReplaceWithScan(root, op, std::move(replacement));
+	}
+}
+
+// Resolve a TOP_N sort expression to the index of an output column of the aggregation scan.
+static bool ResolveAggregateColumn(const Expression &expr, const ElasticsearchScanMatch &match, idx_t &column_idx) {
+	auto inlined = expr.Copy();
+	if (!InlineProjections(inlined, match) || inlined->GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &col_ref = inlined->Cast<BoundColumnRefExpression>();
+	auto &column_ids = match.get->GetColumnIds();
+	idx_t column_pos = col_ref.binding.column_index.GetIndexUnsafe();
+	if (col_ref.binding.table_index != match.get->table_index || column_pos >= column_ids.size()) {
+		return false;
+	}
+	column_idx = column_ids[column_pos].GetPrimaryIndex();
+	return true;
+}
+
+// Try to turn the composite aggregation below a TOP_N into a terms aggregation returning only the top buckets.
+// Applies to a single terms group ordered by count(*) DESC, optionally followed by the group key. Elasticsearch
+// orders terms buckets by [_count, _key], which is the same order, so the TOP_N only reorders the returned rows.
+static bool TryPushdownTopK(LogicalTopN &top_n) {
+	ElasticsearchScanMatch match;
+	reference<LogicalOperator> current = *top_n.children[0];
+	while (current.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+		match.projections.push_back(current.get().Cast<LogicalProjection>());
+		current = *current.get().children[0];
+	}
+	if (current.get().type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = current.get().Cast<LogicalGet>();
+	if (get.function.name != "elasticsearch_aggregate" || !get.bind_data) {
+		return false;
+	}
+	match.get = &get;
+	auto &bind_data = get.bind_data->Cast<ElasticsearchAggregateBindData>();
+	// A composite aggregation below a nested aggregation is not rewritten.
+	if (!bind_data.generated || bind_data.mode != ElasticsearchAggregateMode::COMPOSITE ||
+	    bind_data.filtered_buckets || bind_data.levels[0] != "groups") {
+		return false;
+	}
+
+	// The first sort key must be count(*) DESC, a second one may be the group key.
+	idx_t k = top_n.limit + top_n.offset;
+	if (k == 0 || top_n.orders.empty() || top_n.orders.size() > 2) {
+		return false;
+	}
+	idx_t count_idx, key_idx;
+	if (!ResolveAggregateColumn(*top_n.orders[0].expression, match, count_idx) ||
+	    count_idx >= bind_data.columns.size() || bind_data.columns[count_idx].value_path != "doc_count" ||
+	    !bind_data.columns[count_idx].hits_path.empty() ||
+	    top_n.orders[0].type != OrderType::DESCENDING) {
+		return false;
+	}
+	bool key_descending = false;
+	if (top_n.orders.size() == 2) {
+		if (!ResolveAggregateColumn(*top_n.orders[1].expression, match, key_idx) ||
+		    key_idx >= bind_data.columns.size() || bind_data.columns[key_idx].value_path != "key.g0" ||
+		    !bind_data.columns[key_idx].hits_path.empty()) {
+			return false;
+		}
+		key_descending = top_n.orders[1].type == OrderType::DESCENDING;
+	}
+
+	// Rewrite {"composite": {"sources": [{"g0": {"terms": {...}}}]}, "aggs": ...} into a terms aggregation.
+	yyjson_doc *request_doc = yyjson_read(bind_data.request.c_str(), bind_data.request.size(), 0);
+	if (!request_doc) {
+		return false;
+	}
+	yyjson_mut_doc *doc = yyjson_doc_mut_copy(request_doc, nullptr);
+	yyjson_doc_free(request_doc);
+
+	yyjson_mut_val *aggs = yyjson_mut_obj_get(yyjson_mut_doc_get_root(doc), "aggs");
+	yyjson_mut_val *groups = yyjson_mut_obj_get(aggs, "groups");
+	yyjson_mut_val *sources = yyjson_mut_obj_get(yyjson_mut_obj_get(groups, "composite"), "sources");
+	yyjson_mut_val *source = yyjson_mut_obj_get(yyjson_mut_obj_get(yyjson_mut_arr_get_first(sources), "g0"), "terms");
+	yyjson_mut_val *field = yyjson_mut_obj_get(source, "field");
+	if (yyjson_mut_arr_size(sources) != 1 || !field) {
+		yyjson_mut_doc_free(doc);
+		return false;
+	}
+
+	// shard_size follows the Elasticsearch default (size * 1.5 + 10), set explicitly so it is visible in the request.
+	yyjson_mut_val *terms = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, terms, "field", yyjson_mut_val_mut_copy(doc, field));
+	yyjson_mut_obj_add_uint(doc, terms, "size", k);
+	yyjson_mut_obj_add_uint(doc, terms, "shard_size", k + k / 2 + 10);
+	yyjson_mut_val *order = yyjson_mut_arr(doc);
+	yyjson_mut_val *count_order = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_str(doc, count_order, "_count", "desc");
+	yyjson_mut_arr_append(order, count_order);
+	yyjson_mut_val *key_order = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_str(doc, key_order, "_key", key_descending ? "desc" : "asc");
+	yyjson_mut_arr_append(order, key_order);
+	yyjson_mut_obj_add_val(doc, terms, "order", order);
+
+	yyjson_mut_val *metrics = yyjson_mut_obj_get(groups, "aggs");
+	yyjson_mut_obj_remove_key(groups, "composite");
+	yyjson_mut_obj_add_val(doc, groups, "terms", terms);
+
+	// Documents without a value are not part of any terms bucket, a missing aggregation counts them.
+	yyjson_mut_val *missing_body = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, missing_body, "field", yyjson_mut_val_mut_copy(doc, field));
+	yyjson_mut_val *missing = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, missing, "missing", missing_body);
+	if (metrics) {
+		yyjson_mut_obj_add_val(doc, missing, "aggs", yyjson_mut_val_mut_copy(doc, metrics));
+	}
+	yyjson_mut_obj_add_val(doc, aggs, "missing", missing);
+
+	char *json_str = yyjson_mut_write(doc, 0, nullptr);
+	if (json_str) {
+		bind_data.request = json_str;
+		free(json_str);
+	}
+	yyjson_mut_doc_free(doc);
+
+	bind_data.mode = ElasticsearchAggregateMode::TERMS;
+	for (auto &column : bind_data.columns) {
+		if (column.hits_path.empty() && column.value_path == "key.g0") {
+			column.value_path = "key";
+		}
+	}
+	return true;
+}
+
+// Walks the plan looking for TOP_N operators above an aggregation scan (approximate top-k).
+static void PushdownTopK(unique_ptr<LogicalOperator> &op) {
+	if (op->type == LogicalOperatorType::LOGICAL_TOP_N && TryPushdownTopK(op->Cast<LogicalTopN>())) {
+		return;
+	}
+	for (auto &child : op->children) {
+		PushdownTopK(child);
+	}
+}
+
+void OptimizeAggregatePushdown(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
+	Value setting_val;
+	if (input.context.TryGetCurrentSetting("elasticsearch_aggregate_pushdown", setting_val) &&
+	    !BooleanValue::Get(setting_val)) {
+		return;
+	}
+	PushdownAggregates(input.optimizer.binder, plan, plan);
+
+	if (input.context.TryGetCurrentSetting("elasticsearch_approximate_top_k", setting_val) &&
+	    BooleanValue::Get(setting_val)) {
+		PushdownTopK(plan);
+	}
+}
+
+} // namespace duckdb
@@ -387,17 +387,17 @@ ElasticsearchResponse ElasticsearchClient::Search(const std::string &index, cons
 
 ElasticsearchResponse ElasticsearchClient::ScrollSearch(const std::string &index, const std::string &query,
                                                         const std::string &scroll_time, int64_t size) {
-	// Use filter_path to strip unnecessary metadata from the response. Only _scroll_id, hit _id and _source are needed
-	// by the scan.
+	// Use filter_path to strip unnecessary metadata from the response. Only _scroll_id, hit _id, _score and _source
+	// are needed by the scan.
 	std::string path = "/" + index + "/_search?scroll=" + scroll_time + "&size=" + std::to_string(size) +
-	                   "&filter_path=_scroll_id,hits.hits._id,hits.hits._source";
+	                   "&filter_path=_scroll_id,hits.hits._id,hits.hits._score,hits.hits._source";
 	return PerformRequestWithRetry("POST", path, query);
 }
 
 ElasticsearchResponse ElasticsearchClient::ScrollNext(const std::string &scroll_id, const std::string &scroll_time) {
 	std::string body = R"({"scroll":")" + scroll_time + R"(","scroll_id":")" + scroll_id + R"("})";
-	return PerformRequestWithRetry("POST", "/_search/scroll?filter_path=_scroll_id,hits.hits._id,hits.hits._source",
-	                               body);
+	return PerformRequestWithRetry(
+	    "POST", "/_search/scroll?filter_path=_scroll_id,hits.hits._id,hits.hits._score,hits.hits._source", body);
 }
 
 ElasticsearchResponse ElasticsearchClient::ClearScroll(const std::string &scroll_id) {
@@ -406,8 +406,19 @@ ElasticsearchResponse ElasticsearchClient::ClearScroll(const std::string &scroll
 	return PerformRequest("DELETE", "/_search/scroll", body);
 }
 
+ElasticsearchResponse ElasticsearchClient::Aggregate(const std::string &index, const std::string &query) {
+	// No hits are needed for aggregations, so size=0 skips the fetch phase entirely. Size-0 requests can be served
+	// from the shard request cache, and the hit total is never read, so counting it is skipped as well.
+	std::string path = "/" + index + "/_search?size=0&request_cache=true&track_total_hits=false&filter_path=aggregations";
+	return PerformRequestWithRetry("POST", path, query);
+}
+
 ElasticsearchResponse ElasticsearchClient::GetMapping(const std::string &index) {
 	return PerformRequestWithRetry("GET", "/" + index + "/_mapping", "");
 }
 
+ElasticsearchResponse ElasticsearchClient::GetSetting(const std::string &index, const std::string &setting) {
+	return PerformRequestWithRetry("GET", "/" + index + "/_settings/" + setting + "?flat_settings=true", "");
+}
+
 } // namespace duckdb
@@ -7,6 +7,7 @@
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 
 #include <cstring>
+#include <functional>
 
 namespace duckdb {
 
@@ -1120,4 +1121,134 @@ VariantValue ConvertYyjsonToVariantValue(yyjson_val *val) {
 	return VariantValue(Value(""));
 }
 
+// Collect unmapped fields from _source that are not in the schema's mapped paths.
+VariantValue CollectUnmappedFields(yyjson_val *source, const std::set<std::string> &mapped_paths,
+                                   const std::string &prefix) {
+	if (!source || !yyjson_is_obj(source)) {
+		return VariantValue(Value());
+	}
+
+	bool has_unmapped = false;
+	VariantValue result_obj(VariantValueType::OBJECT);
+
+	// Recursive helper to collect unmapped fields.
+	std::function<void(yyjson_val *, VariantValue &, const std::string &)> collect_unmapped =
+	    [&](yyjson_val *obj, VariantValue &target, const std::string &current_prefix) {
+		    if (!obj || !yyjson_is_obj(obj))
+			    return;
+
+		    yyjson_obj_iter iter;
+		    yyjson_obj_iter_init(obj, &iter);
+		    yyjson_val *key;
+
+		    while ((key = yyjson_obj_iter_next(&iter))) {
+			    const char *field_name = yyjson_get_str(key);
+			    yyjson_val *field_val = yyjson_obj_iter_get_val(key);
+
+			    std::string field_path = current_prefix.empty() ? field_name : current_prefix + "." + field_name;
+
+			    // Check if this exact path is mapped.
+			    bool is_mapped = mapped_paths.count(field_path) > 0;
+
+			    // Also check if any mapped path starts with this path (it's a parent of a mapped field).
+			    bool is_parent_of_mapped = false;
+			    for (const auto &mapped_path : mapped_paths) {
+				    if (mapped_path.find(field_path + ".") == 0) {
+					    is_parent_of_mapped = true;
+					    break;
+				    }
+			    }
+
+			    if (is_mapped) {
+				    // This field is mapped, but check if it is an object/nested type with child fields.
+				    // If the field has no children in mapped_paths, it's a terminal type (geo_point etc.)
+				    // and we should not recurse into it even if the value is an object.
+				    bool has_mapped_children = false;
+				    for (const auto &mp : mapped_paths) {
+					    if (mp.find(field_path + ".") == 0) {
+						    has_mapped_children = true;
+						    break;
+					    }
+				    }
+
+				    if (has_mapped_children && yyjson_is_obj(field_val)) {
+					    // This is an object/nested type with defined child fields, check for unmapped children.
+					    VariantValue sub_obj(VariantValueType::OBJECT);
+					    bool sub_has_unmapped = false;
+
+					    yyjson_obj_iter sub_iter;
+					    yyjson_obj_iter_init(field_val, &sub_iter);
+					    yyjson_val *sub_key;
+
+					    while ((sub_key = yyjson_obj_iter_next(&sub_iter))) {
+						    const char *subfield_name = yyjson_get_str(sub_key);
+						    yyjson_val *subfield_val = yyjson_obj_iter_get_val(sub_key);
+						    std::string subfield_path = field_path + "." + subfield_name;
+
+						    if (mapped_paths.count(subfield_path) == 0) {
+							    // Check if it's a parent of any mapped field.
+							    bool is_sub_parent = false;
+							    for (const auto &mp : mapped_paths) {
+								    if (mp.find(subfield_path + ".") == 0) {
+									    is_sub_parent = true;
+									    break;
+								    }
+							    }
+
+							    if (!is_sub_parent) {
+								    // This subfield is unmapped, add it.
+								    sub_obj.AddChild(subfield_name, ConvertYyjsonToVariantValue(subfield_val));
+								    sub_has_unmapped = true;
+							    } else {
+								    // Recurse into this object.
+								    VariantValue nested_obj(VariantValueType::OBJECT);
+								    collect_unmapped(subfield_val, nested_obj, subfield_path);
+								    if (!nested_obj.object_children.empty()) {
+									    sub_obj.AddChild(subfield_name, std::move(nested_obj));
+									    sub_has_unmapped = true;
+								    }
+							    }
+						    } else if (yyjson_is_obj(subfield_val)) {
+							    // Recurse for nested mapped objects.
+							    VariantValue nested_obj(VariantValueType::OBJECT);
+							    collect_unmapped(subfield_val, nested_obj, subfield_path);
+							    if (!nested_obj.object_children.empty()) {
+								    sub_obj.AddChild(subfield_name, std::move(nested_obj));
+								    sub_has_unmapped = true;
+							    }
+						    }
+					    }
+
+					    if (sub_has_unmapped) {
+						    target.AddChild(field_name, std::move(sub_obj));
+						    has_unmapped = true;
+					    }
+				    }
+				    // Terminal type (geo_point, keyword etc.), do not recurse.
+			    } else if (is_parent_of_mapped) {
+				    // This is a parent object of mapped fields, recurse to find unmapped children.
+				    if (yyjson_is_obj(field_val)) {
+					    VariantValue sub_obj(VariantValueType::OBJECT);
+					    collect_unmapped(field_val, sub_obj, field_path);
+					    if (!sub_obj.object_children.empty()) {
+						    target.AddChild(field_name, std::move(sub_obj));
+						    has_unmapped = true;
+					    }
+				    }
+			    } else {
+				    // This field is completely unmapped, add the entire value.
+				    target.AddChild(field_name, ConvertYyjsonToVariantValue(field_val));
+				    has_unmapped = true;
+			    }
+		    }
+	    };
+
+	collect_unmapped(source, result_obj, prefix);
+
+	if (has_unmapped) {
+		return result_obj;
+	}
+	return VariantValue(Value());
+}
+
 } // namespace duckdb
@@ -3,6 +3,7 @@
 #include "elasticsearch_extension.hpp"
 #include "elasticsearch_schema.hpp"
 #include "elasticsearch_query.hpp"
+#include "elasticsearch_aggregate.hpp"
 #include "elasticsearch_optimizer.hpp"
 #include "duckdb.hpp"
 #include "duckdb/common/types/value.hpp"
@@ -19,11 +20,13 @@ static void LoadInternal(ExtensionLoader &loader) {
 
 	// Register table functions.
 	RegisterElasticsearchQueryFunction(loader);
+	RegisterElasticsearchAggregateFunction(loader);
 
 	// Register scalar functions.
 	RegisterElasticsearchClearCacheFunction(loader);
+	RegisterElasticsearchFullTextFunctions(loader);
 
-	// Register optimizer extension for _id semantic optimization and LIMIT/OFFSET pushdown.
+	// Register optimizer extension for _id semantic optimization, aggregate pushdown and LIMIT/OFFSET pushdown.
 	auto &config = DBConfig::GetConfig(loader.GetDatabaseInstance());
 	OptimizerExtension::Register(config, ElasticsearchOptimizerExtension());
 
@@ -55,6 +58,17 @@ static void LoadInternal(ExtensionLoader &loader) {
 	config.AddExtensionOption("elasticsearch_scroll_time",
 	                          "Scroll context keep-alive duration for data fetching (e.g. '5m', '1h')",
 	                          LogicalType::VARCHAR, Value("5m"));
+	config.AddExtensionOption("elasticsearch_aggregate_pushdown",
+	                          "Whether to push GROUP BY aggregates down to Elasticsearch aggregations",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(true));
+	config.AddExtensionOption("elasticsearch_approximate_top_k",
+	                          "Whether to answer GROUP BY ... ORDER BY count(*) DESC LIMIT k with an approximate "
+	                          "Elasticsearch terms aggregation",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
+	config.AddExtensionOption("elasticsearch_enable_script_pushdown",
+	                          "Whether to push filters that need a script, such as comparisons of the hour of a date "
+	                          "field or of arithmetic on numeric fields, down to Elasticsearch as script queries",
+	                          LogicalType::BOOLEAN, Value::BOOLEAN(false));
 }
 
 void ElasticsearchExtension::Load(ExtensionLoader &loader) {
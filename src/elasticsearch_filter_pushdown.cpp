@@ -6,25 +6,47 @@
 #include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/planner/filter/in_filter.hpp"
 #include "duckdb/planner/filter/expression_filter.hpp"
+#include "duckdb/planner/filter/optional_filter.hpp"
 #include "duckdb/planner/filter/struct_filter.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_operator_expression.hpp"
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
 
 namespace duckdb {
 
 using namespace duckdb_yyjson;
 
-// Get Elasticsearch field name adding .keyword suffix for text fields that have a .keyword subfield.
-// For text fields without .keyword subfield returns the base field name (caller should handle appropriately).
-static std::string GetElasticsearchFieldName(const std::string &column_name, bool is_text_field,
-                                             bool has_keyword_subfield) {
-	if (is_text_field && has_keyword_subfield) {
-		return column_name + ".keyword";
+// Get the Elasticsearch field of exact matches on a column: the keyword subfield of text fields (.keyword or
+// another name such as .raw, see ElasticsearchSchema::keyword_subfields).
+// For text fields without a keyword subfield returns the base field name (caller should handle appropriately).
+static std::string GetElasticsearchFieldName(const std::string &column_name, const ElasticsearchSchema &schema) {
+	if (schema.text_fields.count(column_name) > 0) {
+		auto keyword_subfield = schema.keyword_subfields.find(column_name);
+		if (keyword_subfield != schema.keyword_subfields.end()) {
+			return keyword_subfield->second;
+		}
 	}
 	return column_name;
 }
 
+// Get the Elasticsearch field of wildcard and regexp queries on a column: a wildcard subfield if there is one, as
+// it finds matches with an n-gram index instead of testing every term of the field, otherwise the field of exact
+// matches.
+static std::string GetPatternFieldName(const std::string &column_name, const ElasticsearchSchema &schema) {
+	auto wildcard_subfield = schema.wildcard_subfields.find(column_name);
+	if (wildcard_subfield != schema.wildcard_subfields.end()) {
+		return wildcard_subfield->second;
+	}
+	return GetElasticsearchFieldName(column_name, schema);
+}
+
 // Forward declarations of static helper functions.
 static yyjson_mut_val *TranslateFilter(yyjson_mut_doc *doc, const TableFilter &filter, const string &column_name,
                                        const ElasticsearchSchema &schema);
@@ -41,16 +63,35 @@ static yyjson_mut_val *TranslateConjunctionOr(yyjson_mut_doc *doc, const Conjunc
 static yyjson_mut_val *TranslateInFilter(yyjson_mut_doc *doc, const InFilter &filter, const string &field_name,
                                          const ElasticsearchSchema &schema);
 
+static bool CanTranslateOptionalFilter(const TableFilter &filter, const string &column_name,
+                                       const ElasticsearchSchema &schema);
+
 static yyjson_mut_val *TranslateExpressionFilter(yyjson_mut_doc *doc, const ExpressionFilter &filter,
                                                  const string &column_name, const ElasticsearchSchema &schema);
 
 static yyjson_mut_val *TranslateLikePattern(yyjson_mut_doc *doc, const string &field_name, const string &pattern,
                                             const ElasticsearchSchema &schema, bool case_insensitive);
 
+static yyjson_mut_val *TranslateRegexpMatch(yyjson_mut_doc *doc, const string &field_name, const string &pattern,
+                                            bool partial_match, bool case_insensitive,
+                                            const ElasticsearchSchema &schema);
+
+static yyjson_mut_val *TranslateFullTextPredicate(yyjson_mut_doc *doc, const string &func_name,
+                                                  const string &field_name, const string &query_text);
+
+static yyjson_mut_val *TranslateDatePartScript(yyjson_mut_doc *doc, const Expression &expr, const string &field_name);
+static yyjson_mut_val *TranslateScript(yyjson_mut_doc *doc, const string &source, const child_list_t<Value> &params);
+
+static yyjson_mut_val *TranslateCaseInsensitiveTerms(yyjson_mut_doc *doc, const vector<Value> &values,
+                                                     const string &field_name, const ElasticsearchSchema &schema);
+
 static yyjson_mut_val *TranslateIsNull(yyjson_mut_doc *doc, const string &field_name);
 
 static yyjson_mut_val *TranslateIsNotNull(yyjson_mut_doc *doc, const string &field_name);
 
+static yyjson_mut_val *TranslateNegation(yyjson_mut_doc *doc, yyjson_mut_val *query, const string &field_name,
+                                         bool null_matches);
+
 static yyjson_mut_val *TranslateGeospatialFilter(yyjson_mut_doc *doc, const BoundFunctionExpression &func_expr,
                                                  const string &column_name);
 
@@ -121,6 +162,74 @@ FilterTranslationResult TranslateFilters(yyjson_mut_doc *doc, const TableFilterS
 	return result;
 }
 
+// Translate a boolean predicate tree node, without the nested query of ElasticsearchBooleanFilter::nested_path.
+static yyjson_mut_val *TranslateBooleanFilterNode(yyjson_mut_doc *doc, const ElasticsearchBooleanFilter &filter,
+                                                  const ElasticsearchSchema &schema) {
+	if (!filter.script.empty()) {
+		return TranslateScript(doc, filter.script, filter.script_params);
+	}
+	if (filter.type == ExpressionType::INVALID) {
+		yyjson_mut_val *translated = TranslateFilter(doc, *filter.filter, filter.column_name, schema);
+		if (!translated || !filter.negated) {
+			return translated;
+		}
+		return TranslateNegation(doc, translated, filter.column_name, false);
+	}
+
+	// {"bool": {"must": [child1, child2, ...]}} or {"bool": {"should": [...], "minimum_should_match": 1}}
+	bool is_or = filter.type == ExpressionType::CONJUNCTION_OR;
+	yyjson_mut_val *children_arr = yyjson_mut_arr(doc);
+	for (auto &child : filter.children) {
+		yyjson_mut_val *translated = TranslateBooleanFilter(doc, *child, schema);
+		if (!translated) {
+			// Leaving out a child of OR would drop matching documents. Leaving out a child of AND only
+			// widens the match, which is what happens to untranslated top-level filters as well.
+			if (is_or) {
+				return nullptr;
+			}
+			continue;
+		}
+		yyjson_mut_arr_append(children_arr, translated);
+	}
+
+	if (yyjson_mut_arr_size(children_arr) == 0) {
+		return nullptr;
+	}
+
+	if (yyjson_mut_arr_size(children_arr) == 1) {
+		return yyjson_mut_arr_get_first(children_arr);
+	}
+
+	yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+	if (is_or) {
+		yyjson_mut_obj_add_val(doc, bool_obj, "should", children_arr);
+		yyjson_mut_obj_add_int(doc, bool_obj, "minimum_should_match", 1);
+	} else {
+		yyjson_mut_obj_add_val(doc, bool_obj, "must", children_arr);
+	}
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
+	return result;
+}
+
+yyjson_mut_val *TranslateBooleanFilter(yyjson_mut_doc *doc, const ElasticsearchBooleanFilter &filter,
+                                       const ElasticsearchSchema &schema) {
+	yyjson_mut_val *translated = TranslateBooleanFilterNode(doc, filter, schema);
+	if (!translated || filter.nested_path.empty()) {
+		return translated;
+	}
+
+	// {"nested": {"path": "nested_path", "query": translated}}
+	yyjson_mut_val *nested = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, nested, "path", filter.nested_path.c_str());
+	yyjson_mut_obj_add_val(doc, nested, "query", translated);
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "nested", nested);
+	return result;
+}
+
 // Translate a single filter for a specific column.
 // The schema is passed through to child functions for field type lookups.
 static yyjson_mut_val *TranslateFilter(yyjson_mut_doc *doc, const TableFilter &filter, const string &column_name,
@@ -157,6 +266,18 @@ static yyjson_mut_val *TranslateFilter(yyjson_mut_doc *doc, const TableFilter &f
 		return TranslateExpressionFilter(doc, expr_filter, column_name, schema);
 	}
 
+	case TableFilterType::OPTIONAL_FILTER: {
+		// Runtime filters from the build side of a hash join (min/max range or the set of keys). Skipping them
+		// is always correct since the join still compares the keys, so they are only translated where the
+		// query is guaranteed to keep every document that can join.
+		auto &optional_filter = filter.Cast<OptionalFilter>();
+		if (!optional_filter.child_filter ||
+		    !CanTranslateOptionalFilter(*optional_filter.child_filter, column_name, schema)) {
+			return nullptr;
+		}
+		return TranslateFilter(doc, *optional_filter.child_filter, column_name, schema);
+	}
+
 	case TableFilterType::STRUCT_EXTRACT: {
 		// Handle filters on nested struct fields.
 		// The StructFilter wraps the child filter with the nested field name.
@@ -176,6 +297,33 @@ static yyjson_mut_val *TranslateFilter(yyjson_mut_doc *doc, const TableFilter &f
 	}
 }
 
+// Check whether the child of an optional (join) filter can be translated into a query matching a superset of the
+// documents whose _source value passes it. Term and range queries compare indexed values, which differ from the
+// _source values for text fields (analyzed), keyword fields with ignore_above (longer values are not indexed), ip
+// fields (ordered by address) and half_float/scaled_float fields (rounded). Array fields are LISTs in DuckDB and _id
+// supports terms but not range queries.
+static bool CanTranslateOptionalFilter(const TableFilter &filter, const string &column_name,
+                                       const ElasticsearchSchema &schema) {
+	if (column_name == "_id") {
+		return filter.filter_type == TableFilterType::IN_FILTER;
+	}
+	auto column = std::find(schema.column_names.begin(), schema.column_names.end(), column_name);
+	if (column == schema.column_names.end() ||
+	    schema.column_types[column - schema.column_names.begin()].id() == LogicalTypeId::LIST) {
+		return false;
+	}
+	static const std::set<string> exact_types = {"long",  "integer", "short", "byte",    "double",
+	                                             "float", "boolean", "date",  "keyword", "constant_keyword"};
+	auto es_type = schema.es_type_map.find(column_name);
+	if (es_type == schema.es_type_map.end() || exact_types.count(es_type->second) == 0 ||
+	    schema.ignore_above_fields.count(column_name) > 0) {
+		return false;
+	}
+	return filter.filter_type == TableFilterType::CONSTANT_COMPARISON ||
+	       filter.filter_type == TableFilterType::IN_FILTER ||
+	       filter.filter_type == TableFilterType::CONJUNCTION_AND;
+}
+
 static yyjson_mut_val *TranslateConstantComparison(yyjson_mut_doc *doc, const ConstantFilter &filter,
                                                    const string &field_name, const ElasticsearchSchema &schema) {
 	bool is_text_field = schema.text_fields.count(field_name) > 0;
@@ -197,7 +345,7 @@ static yyjson_mut_val *TranslateConstantComparison(yyjson_mut_doc *doc, const Co
 		return nullptr;
 	}
 
-	string es_field = GetElasticsearchFieldName(field_name, is_text_field, has_keyword_subfield);
+	string es_field = GetElasticsearchFieldName(field_name, schema);
 	yyjson_mut_val *value = ConvertDuckDBToJSON(doc, filter.constant);
 
 	switch (filter.comparison_type) {
@@ -213,20 +361,14 @@ static yyjson_mut_val *TranslateConstantComparison(yyjson_mut_doc *doc, const Co
 	}
 
 	case ExpressionType::COMPARE_NOTEQUAL: {
-		// {"bool": {"must_not": {"term": {"field": value}}}}
+		// {"bool": {"must": {"exists": {"field": "field"}}, "must_not": {"term": {"field": value}}}}
 		yyjson_mut_val *term_inner = yyjson_mut_obj(doc);
 		yyjson_mut_val *key_ne = yyjson_mut_strcpy(doc, es_field.c_str());
 		yyjson_mut_obj_add(term_inner, key_ne, value);
 
 		yyjson_mut_val *term = yyjson_mut_obj(doc);
 		yyjson_mut_obj_add_val(doc, term, "term", term_inner);
-
-		yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
-		yyjson_mut_obj_add_val(doc, bool_obj, "must_not", term);
-
-		yyjson_mut_val *result = yyjson_mut_obj(doc);
-		yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
-		return result;
+		return TranslateNegation(doc, term, field_name, false);
 	}
 
 	// For text fields with .keyword subfield range queries work correctly.
@@ -319,6 +461,23 @@ static yyjson_mut_val *TranslateIsNotNull(yyjson_mut_doc *doc, const string &fie
 	return result;
 }
 
+// Negate a translated query on a single field following SQL NULL semantics: {"bool": {"must_not": query}} matches
+// documents without the field, while NOT (x = 1), x != 1 or x NOT LIKE 'a%' are NULL and not true for NULL x.
+// Unless null_matches is set (as for IS DISTINCT FROM), an exists clause keeps such documents out:
+// {"bool": {"must": {"exists": {"field": "field"}}, "must_not": query}}. _id always exists and needs no guard.
+static yyjson_mut_val *TranslateNegation(yyjson_mut_doc *doc, yyjson_mut_val *query, const string &field_name,
+                                         bool null_matches) {
+	yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+	if (!null_matches && field_name != "_id") {
+		yyjson_mut_obj_add_val(doc, bool_obj, "must", TranslateIsNotNull(doc, field_name));
+	}
+	yyjson_mut_obj_add_val(doc, bool_obj, "must_not", query);
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
+	return result;
+}
+
 static yyjson_mut_val *TranslateConjunctionAnd(yyjson_mut_doc *doc, const ConjunctionAndFilter &filter,
                                                const string &column_name, const ElasticsearchSchema &schema) {
 	// {"bool": {"must": [filter1, filter2, ...]}}
@@ -354,9 +513,12 @@ static yyjson_mut_val *TranslateConjunctionOr(yyjson_mut_doc *doc, const Conjunc
 
 	for (auto &child_filter : filter.child_filters) {
 		yyjson_mut_val *translated = TranslateFilter(doc, *child_filter, column_name, schema);
-		if (translated) {
-			yyjson_mut_arr_append(should_arr, translated);
+		if (!translated) {
+			// Leaving out an alternative would drop the documents matching it, so the whole OR is left
+			// untranslated instead.
+			return nullptr;
 		}
+		yyjson_mut_arr_append(should_arr, translated);
 	}
 
 	if (yyjson_mut_arr_size(should_arr) == 0) {
@@ -397,20 +559,44 @@ static yyjson_mut_val *TranslateInFilter(yyjson_mut_doc *doc, const InFilter &fi
 
 	// {"terms": {"field": [value1, value2, ...]}}
 	// or for text fields with .keyword: {"terms": {"field.keyword": [value1, value2, ...]}}
-	string es_field = GetElasticsearchFieldName(field_name, is_text_field, has_keyword_subfield);
+	string es_field = GetElasticsearchFieldName(field_name, schema);
+
+	// Sort and deduplicate the values, so that the same IN list always produces the same query.
+	vector<Value> values = filter.values;
+	std::sort(values.begin(), values.end());
+	values.erase(std::unique(values.begin(), values.end()), values.end());
+
+	// A terms query accepts at most index.max_terms_count values. Longer lists are split into chunks of that size
+	// combined with bool.should, which Elasticsearch evaluates in a single request.
+	auto chunk_size = static_cast<idx_t>(MaxValue<int64_t>(schema.max_terms_count, 1));
+	yyjson_mut_val *should_arr = yyjson_mut_arr(doc);
+	for (idx_t chunk_start = 0; chunk_start < values.size(); chunk_start += chunk_size) {
+		idx_t chunk_end = MinValue<idx_t>(chunk_start + chunk_size, values.size());
+		yyjson_mut_val *values_arr = yyjson_mut_arr(doc);
+		for (idx_t i = chunk_start; i < chunk_end; i++) {
+			yyjson_mut_arr_append(values_arr, ConvertDuckDBToJSON(doc, values[i]));
+		}
+
+		yyjson_mut_val *terms_inner = yyjson_mut_obj(doc);
+		yyjson_mut_val *key_in = yyjson_mut_strcpy(doc, es_field.c_str());
+		yyjson_mut_obj_add(terms_inner, key_in, values_arr);
 
-	yyjson_mut_val *values_arr = yyjson_mut_arr(doc);
-	for (auto &value : filter.values) {
-		yyjson_mut_val *json_val = ConvertDuckDBToJSON(doc, value);
-		yyjson_mut_arr_append(values_arr, json_val);
+		yyjson_mut_val *terms = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, terms, "terms", terms_inner);
+		yyjson_mut_arr_append(should_arr, terms);
 	}
 
-	yyjson_mut_val *terms_inner = yyjson_mut_obj(doc);
-	yyjson_mut_val *key_in = yyjson_mut_strcpy(doc, es_field.c_str());
-	yyjson_mut_obj_add(terms_inner, key_in, values_arr);
+	if (yyjson_mut_arr_size(should_arr) == 1) {
+		return yyjson_mut_arr_get_first(should_arr);
+	}
+
+	// {"bool": {"should": [{"terms": ...}, {"terms": ...}], "minimum_should_match": 1}}
+	yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, bool_obj, "should", should_arr);
+	yyjson_mut_obj_add_int(doc, bool_obj, "minimum_should_match", 1);
 
 	yyjson_mut_val *result = yyjson_mut_obj(doc);
-	yyjson_mut_obj_add_val(doc, result, "terms", terms_inner);
+	yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
 	return result;
 }
 
@@ -418,7 +604,15 @@ static yyjson_mut_val *TranslateExpressionFilter(yyjson_mut_doc *doc, const Expr
                                                  const string &column_name, const ElasticsearchSchema &schema) {
 	// ExpressionFilter contains arbitrary expressions. We handle:
 	// - LIKE/ILIKE patterns (~~, ~~*, like_escape, ilike_escape)
+	// - NOT LIKE/NOT ILIKE patterns (!~~, !~~*, not_like_escape, not_ilike_escape)
 	// - Optimized string functions from LikeOptimizationRule (prefix, suffix, contains)
+	// - IS DISTINCT FROM / IS NOT DISTINCT FROM a constant
+	// - Regular expressions (regexp_matches, regexp_full_match)
+	// - Full-text predicates (es_match, es_match_phrase, es_query_string)
+	// - Comparisons and BETWEEN on date parts (hour, month, ...), as script queries
+	// - Comparisons with a time relative to now(), as range queries with date math
+	// - List predicates on array fields (list_contains, list_has_any, list_has_all) and len(col) > 0
+	// - Equality, inequality and IN on lower(col) / upper(col), as case-insensitive term queries
 	// - ST_Distance comparisons
 	// - Spatial extension functions ST_DWithin, ST_Within, ST_Intersects, ST_Contains, ST_Disjoint
 	//
@@ -433,8 +627,12 @@ static yyjson_mut_val *TranslateExpressionFilter(yyjson_mut_doc *doc, const Expr
 		auto &func_expr = expr.Cast<BoundFunctionExpression>();
 		auto func_name = func_expr.function.name;
 
-		// Handle LIKE (~~, like_escape) and ILIKE (~~*, ilike_escape).
-		if (func_name == "~~" || func_name == "like_escape" || func_name == "~~*" || func_name == "ilike_escape") {
+		// Handle LIKE (~~, like_escape) and ILIKE (~~*, ilike_escape), and their negations NOT LIKE (!~~,
+		// not_like_escape) and NOT ILIKE (!~~*, not_ilike_escape).
+		bool is_not_like = func_name == "!~~" || func_name == "not_like_escape" || func_name == "!~~*" ||
+		                   func_name == "not_ilike_escape";
+		if (func_name == "~~" || func_name == "like_escape" || func_name == "~~*" || func_name == "ilike_escape" ||
+		    is_not_like) {
 			// LIKE pattern is typically the second argument (index 1).
 			// First argument (index 0) is the column reference.
 			if (func_expr.children.size() >= 2) {
@@ -443,10 +641,16 @@ static yyjson_mut_val *TranslateExpressionFilter(yyjson_mut_doc *doc, const Expr
 					auto &const_expr = pattern_expr->Cast<BoundConstantExpression>();
 					if (const_expr.value.type().id() == LogicalTypeId::VARCHAR) {
 						string pattern = StringValue::Get(const_expr.value);
-						// ~~* and ilike_escape are case-insensitive (ILIKE)
-						// ~~ and like_escape are case-sensitive (LIKE)
-						bool case_insensitive = (func_name == "~~*" || func_name == "ilike_escape");
-						return TranslateLikePattern(doc, column_name, pattern, schema, case_insensitive);
+						// ~~*, ilike_escape, !~~* and not_ilike_escape are case-insensitive (ILIKE)
+						// ~~, like_escape, !~~ and not_like_escape are case-sensitive (LIKE)
+						bool case_insensitive = (func_name == "~~*" || func_name == "ilike_escape" ||
+						                         func_name == "!~~*" || func_name == "not_ilike_escape");
+						yyjson_mut_val *like_query =
+						    TranslateLikePattern(doc, column_name, pattern, schema, case_insensitive);
+						if (!like_query || !is_not_like) {
+							return like_query;
+						}
+						return TranslateNegation(doc, like_query, column_name, false);
 					}
 				}
 			}
@@ -499,6 +703,166 @@ static yyjson_mut_val *TranslateExpressionFilter(yyjson_mut_doc *doc, const Expr
 		}
 	}
 
+	// Handle list predicates on array fields, normalized by pushdown_complex_filter to the column on the left and a
+	// non-NULL constant on the right. Every value of an array field is indexed, so a term query matches documents
+	// with the value among the values of the field:
+	// - list_contains(col, value) -> {"term": {"col": value}}
+	// - list_has_any(col, [values]) -> {"terms": {"col": [values]}}
+	// - list_has_all(col, [values]) -> {"bool": {"must": [{"term": {"col": value1}}, ...]}}
+	if (expr.type == ExpressionType::BOUND_FUNCTION) {
+		auto &func_expr = expr.Cast<BoundFunctionExpression>();
+		const auto &func_name = func_expr.function.name;
+		bool is_contains = func_name == "list_contains" || func_name == "list_has" || func_name == "array_contains" ||
+		                   func_name == "array_has";
+		bool is_has_any = func_name == "list_has_any" || func_name == "array_has_any" || func_name == "&&";
+		bool is_has_all = func_name == "list_has_all" || func_name == "array_has_all" || func_name == "@>";
+		if ((is_contains || is_has_any || is_has_all) && func_expr.children.size() == 2 &&
+		    func_expr.children[1]->type == ExpressionType::VALUE_CONSTANT) {
+			auto &value = func_expr.children[1]->Cast<BoundConstantExpression>().value;
+			if (is_contains) {
+				ConstantFilter equal_filter(ExpressionType::COMPARE_EQUAL, value);
+				return TranslateConstantComparison(doc, equal_filter, column_name, schema);
+			}
+			auto &values = ListValue::GetChildren(value);
+			if (is_has_any) {
+				InFilter in_filter(values);
+				return TranslateInFilter(doc, in_filter, column_name, schema);
+			}
+			yyjson_mut_val *must_arr = yyjson_mut_arr(doc);
+			for (auto &list_value : values) {
+				ConstantFilter equal_filter(ExpressionType::COMPARE_EQUAL, list_value);
+				yyjson_mut_val *term = TranslateConstantComparison(doc, equal_filter, column_name, schema);
+				if (!term) {
+					return nullptr;
+				}
+				yyjson_mut_arr_append(must_arr, term);
+			}
+			yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, bool_obj, "must", must_arr);
+			yyjson_mut_val *result = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
+			return result;
+		}
+	}
+
+	// Handle len(col) > 0, normalized by pushdown_complex_filter from the other ways to test an array or nested field
+	// for values: {"exists": {"field": "col"}}, or {"nested": {"path": "col", "query": {"match_all": {}}}} for nested
+	// fields, whose values are separate documents.
+	if (expr.type == ExpressionType::COMPARE_GREATERTHAN) {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		if (comp_expr.left->type == ExpressionType::BOUND_FUNCTION) {
+			const auto &func_name = comp_expr.left->Cast<BoundFunctionExpression>().function.name;
+			if (func_name == "len" || func_name == "length" || func_name == "array_length") {
+				auto es_type = schema.es_type_map.find(column_name);
+				if (es_type == schema.es_type_map.end() || es_type->second != "nested") {
+					return TranslateIsNotNull(doc, column_name);
+				}
+				yyjson_mut_val *nested = yyjson_mut_obj(doc);
+				yyjson_mut_obj_add_strcpy(doc, nested, "path", column_name.c_str());
+				yyjson_mut_val *match_all = yyjson_mut_obj(doc);
+				yyjson_mut_obj_add_val(doc, match_all, "match_all", yyjson_mut_obj(doc));
+				yyjson_mut_obj_add_val(doc, nested, "query", match_all);
+
+				yyjson_mut_val *result = yyjson_mut_obj(doc);
+				yyjson_mut_obj_add_val(doc, result, "nested", nested);
+				return result;
+			}
+		}
+	}
+
+	// Handle lower(col) / upper(col) compared with constants, normalized by pushdown_complex_filter to the function
+	// on the left: = and IN match the values case-insensitively, != is their negation.
+	bool upper;
+	if ((expr.type == ExpressionType::COMPARE_EQUAL || expr.type == ExpressionType::COMPARE_NOTEQUAL) &&
+	    ExtractCaseConversion(*expr.Cast<BoundComparisonExpression>().left, upper)) {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		if (comp_expr.right->type != ExpressionType::VALUE_CONSTANT) {
+			return nullptr;
+		}
+		vector<Value> values {comp_expr.right->Cast<BoundConstantExpression>().value};
+		yyjson_mut_val *query = TranslateCaseInsensitiveTerms(doc, values, column_name, schema);
+		if (!query || expr.type == ExpressionType::COMPARE_EQUAL) {
+			return query;
+		}
+		return TranslateNegation(doc, query, column_name, false);
+	}
+	if (expr.type == ExpressionType::COMPARE_IN &&
+	    ExtractCaseConversion(*expr.Cast<BoundOperatorExpression>().children[0], upper)) {
+		auto &op_expr = expr.Cast<BoundOperatorExpression>();
+		vector<Value> values;
+		for (idx_t i = 1; i < op_expr.children.size(); i++) {
+			if (op_expr.children[i]->type != ExpressionType::VALUE_CONSTANT) {
+				return nullptr;
+			}
+			values.push_back(op_expr.children[i]->Cast<BoundConstantExpression>().value);
+		}
+		return TranslateCaseInsensitiveTerms(doc, values, column_name, schema);
+	}
+
+	// Handle regexp_matches(col, 'pattern'[, 'options']) and regexp_full_match (the ~ operator).
+	if (expr.type == ExpressionType::BOUND_FUNCTION) {
+		auto &func_expr = expr.Cast<BoundFunctionExpression>();
+		const auto &func_name = func_expr.function.name;
+		string pattern;
+		bool case_insensitive;
+		if ((func_name == "regexp_matches" || func_name == "regexp_full_match") &&
+		    ExtractRegexpArguments(func_expr, pattern, case_insensitive)) {
+			return TranslateRegexpMatch(doc, column_name, pattern, func_name == "regexp_matches", case_insensitive,
+			                            schema);
+		}
+	}
+
+	// Handle the full-text predicates es_match(col, 'query'), es_match_phrase and es_query_string.
+	if (expr.type == ExpressionType::BOUND_FUNCTION) {
+		auto &func_expr = expr.Cast<BoundFunctionExpression>();
+		const auto &func_name = func_expr.function.name;
+		if ((func_name == "es_match" || func_name == "es_match_phrase" || func_name == "es_query_string") &&
+		    func_expr.children.size() == 2 && func_expr.children[1]->type == ExpressionType::VALUE_CONSTANT) {
+			auto &const_expr = func_expr.children[1]->Cast<BoundConstantExpression>();
+			if (!const_expr.value.IsNull()) {
+				return TranslateFullTextPredicate(doc, func_name, column_name, StringValue::Get(const_expr.value));
+			}
+		}
+	}
+
+	// Handle IS DISTINCT FROM / IS NOT DISTINCT FROM, normalized by pushdown_complex_filter to a column on the
+	// left and a non-NULL constant on the right. Unlike = and !=, they are never NULL: a document without the
+	// field is distinct from every value.
+	if (expr.type == ExpressionType::COMPARE_DISTINCT_FROM || expr.type == ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		if (comp_expr.right->type == ExpressionType::VALUE_CONSTANT) {
+			auto &const_expr = comp_expr.right->Cast<BoundConstantExpression>();
+			ConstantFilter equal_filter(ExpressionType::COMPARE_EQUAL, const_expr.value);
+			yyjson_mut_val *term = TranslateConstantComparison(doc, equal_filter, column_name, schema);
+			if (!term || expr.type == ExpressionType::COMPARE_NOT_DISTINCT_FROM) {
+				return term;
+			}
+			return TranslateNegation(doc, term, column_name, true);
+		}
+	}
+
+	// Handle comparisons with a time relative to the current time, normalized by pushdown_complex_filter to the
+	// column on the left: col > now() - INTERVAL 15 MINUTE -> {"range": {"col": {"gt": "now-15m"}}}.
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		string date_math;
+		bool rounded;
+		if (ExtractDateMath(*comp_expr.right, date_math, rounded)) {
+			ConstantFilter range_filter(comp_expr.GetExpressionType(), Value(date_math));
+			return TranslateConstantComparison(doc, range_filter, column_name, schema);
+		}
+	}
+
+	// Handle date part comparisons such as hour(col) BETWEEN 9 AND 17, normalized by pushdown_complex_filter to the
+	// date part on the left and integer constants on the right. Only pushed with elasticsearch_enable_script_pushdown.
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON ||
+	    expr.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+		auto result = TranslateDatePartScript(doc, expr, column_name);
+		if (result) {
+			return result;
+		}
+	}
+
 	// Handle comparison expressions containing ST_Distance.
 	// Pattern: ST_Distance(geo_col, point) </<=/>/>= distance
 	if (expr.type == ExpressionType::COMPARE_LESSTHAN || expr.type == ExpressionType::COMPARE_LESSTHANOREQUALTO ||
@@ -538,15 +902,9 @@ static yyjson_mut_val *TranslateLikePattern(yyjson_mut_doc *doc, const string &f
 		return nullptr;
 	}
 
-	// Determine the field to use for the query.
-	string es_field;
-	if (is_text_field && has_keyword_subfield) {
-		// Text field with .keyword subfield, always use .keyword for both LIKE and ILIKE.
-		es_field = field_name + ".keyword";
-	} else {
-		// Non-text field (keyword etc.), use base field.
-		es_field = field_name;
-	}
+	// Determine the field to use for the query: the .keyword subfield of text fields for both LIKE and ILIKE, the
+	// base field for keyword fields.
+	string es_field = GetElasticsearchFieldName(field_name, schema);
 
 	// Check if pattern has any wildcards.
 	bool has_percent = pattern.find('%') != string::npos;
@@ -632,8 +990,9 @@ static yyjson_mut_val *TranslateLikePattern(yyjson_mut_doc *doc, const string &f
 		}
 	}
 
-	// Use wildcard query.
+	// Use wildcard query, on a wildcard subfield if there is one.
 	// {"wildcard": {"field": {"value": "pattern"}}} or with case_insensitive option
+	es_field = GetPatternFieldName(field_name, schema);
 	yyjson_mut_val *wildcard_value = yyjson_mut_obj(doc);
 	yyjson_mut_obj_add_strcpy(doc, wildcard_value, "value", es_pattern.c_str());
 	if (case_insensitive) {
@@ -649,6 +1008,730 @@ static yyjson_mut_val *TranslateLikePattern(yyjson_mut_doc *doc, const string &f
 	return result;
 }
 
+// Append a literal character to a Lucene regular expression. Lucene gives special meaning to more characters than
+// RE2 (e.g. @, &, ~, #, <, > and ") and accepts a backslash before any character, so everything except ASCII
+// letters and digits is escaped. Bytes of multi-byte UTF-8 characters are appended unchanged.
+static void AppendLuceneLiteral(string &result, char c) {
+	if (!StringUtil::CharacterIsAlphaNumeric(c) && static_cast<unsigned char>(c) < 0x80) {
+		result += '\\';
+	}
+	result += c;
+}
+
+// Translate the RE2 escape sequence \c. Perl classes (\d, \w, \s) are expanded since Lucene does not know them,
+// control character escapes become the character itself. Inside a character class only the class contents are
+// appended and negated Perl classes are rejected. Returns false for escapes without a Lucene equivalent
+// (word boundaries, \A, \z, Unicode classes, hex and octal escapes, back-references, \Q...\E).
+static bool AppendRegexEscape(string &result, char c, bool in_class) {
+	static const char *DIGIT_CLASS = "0-9";
+	static const char *WORD_CLASS = "a-zA-Z0-9_";
+	static const char *SPACE_CLASS = "\t\n\f\r ";
+
+	const char *perl_class = nullptr;
+	bool negated = false;
+	switch (c) {
+	case 'd':
+	case 'D':
+		perl_class = DIGIT_CLASS;
+		negated = c == 'D';
+		break;
+	case 'w':
+	case 'W':
+		perl_class = WORD_CLASS;
+		negated = c == 'W';
+		break;
+	case 's':
+	case 'S':
+		perl_class = SPACE_CLASS;
+		negated = c == 'S';
+		break;
+	case 'a':
+		result += '\a';
+		return true;
+	case 'f':
+		result += '\f';
+		return true;
+	case 'n':
+		result += '\n';
+		return true;
+	case 'r':
+		result += '\r';
+		return true;
+	case 't':
+		result += '\t';
+		return true;
+	case 'v':
+		result += '\v';
+		return true;
+	default:
+		// Escaped punctuation is a literal, escaped letters and digits are special in RE2.
+		if (StringUtil::CharacterIsAlphaNumeric(c) || static_cast<unsigned char>(c) >= 0x80) {
+			return false;
+		}
+		AppendLuceneLiteral(result, c);
+		return true;
+	}
+
+	if (in_class) {
+		if (negated) {
+			return false;
+		}
+		result += perl_class;
+		return true;
+	}
+	result += negated ? "[^" : "[";
+	result += perl_class;
+	result += ']';
+	return true;
+}
+
+// Translate an RE2 character class starting at pattern[pos] == '[' and advance pos past its closing bracket.
+// Returns false for POSIX classes ([:alpha:]) and unsupported escapes.
+static bool AppendRegexClass(string &result, const string &pattern, idx_t &pos, idx_t end) {
+	result += '[';
+	pos++;
+	if (pos < end && pattern[pos] == '^') {
+		result += '^';
+		pos++;
+	}
+	bool first = true;
+	while (pos < end) {
+		char c = pattern[pos];
+		if (c == ']' && !first) {
+			result += ']';
+			pos++;
+			return true;
+		}
+		if (c == '[' && pos + 1 < end && pattern[pos + 1] == ':') {
+			return false;
+		}
+		if (c == '\\') {
+			if (pos + 1 >= end || !AppendRegexEscape(result, pattern[pos + 1], true)) {
+				return false;
+			}
+			pos += 2;
+		} else if (c == '-' && !first && pos + 1 < end && pattern[pos + 1] != ']') {
+			// Range operator between two characters.
+			result += '-';
+			pos++;
+		} else {
+			// A ']' right after '[' or '[^' and a '-' at either end are literals.
+			AppendLuceneLiteral(result, c);
+			pos++;
+		}
+		first = false;
+	}
+	// Unterminated class.
+	return false;
+}
+
+bool ExtractRegexpArguments(const BoundFunctionExpression &func_expr, string &pattern, bool &case_insensitive) {
+	if (func_expr.children.size() != 2 && func_expr.children.size() != 3) {
+		return false;
+	}
+	if (!ExtractConstantString(*func_expr.children[1], pattern)) {
+		return false;
+	}
+	// Options are a string of flags, the last of 'c' (case-sensitive) and 'i' (case-insensitive) wins.
+	// Other flags change how newlines are matched and are not supported.
+	case_insensitive = false;
+	if (func_expr.children.size() == 3) {
+		string options;
+		if (!ExtractConstantString(*func_expr.children[2], options)) {
+			return false;
+		}
+		for (char option : options) {
+			if (option != 'c' && option != 'i') {
+				return false;
+			}
+			case_insensitive = option == 'i';
+		}
+	}
+	return true;
+}
+
+bool TranslateRegexToLucene(const string &pattern, bool partial_match, string &lucene_pattern,
+                            bool &case_insensitive) {
+	idx_t pos = 0;
+	idx_t end = pattern.size();
+
+	// A leading (?i) flag group makes the whole pattern case-insensitive, other flag groups are not supported.
+	if (StringUtil::StartsWith(pattern, "(?i)")) {
+		case_insensitive = true;
+		pos = 4;
+	}
+
+	// Anchors are only supported at the ends of the pattern. Lucene patterns always match the whole value, so
+	// they are dropped and the unanchored ends of a partial match get a .* instead.
+	bool anchored_start = false;
+	bool anchored_end = false;
+	if (pos < end && pattern[pos] == '^') {
+		anchored_start = true;
+		pos++;
+	}
+	if (end > pos && pattern[end - 1] == '$') {
+		idx_t backslashes = 0;
+		while (end - 1 - backslashes > pos && pattern[end - 2 - backslashes] == '\\') {
+			backslashes++;
+		}
+		if (backslashes % 2 == 0) {
+			anchored_end = true;
+			end--;
+		}
+	}
+
+	string body;
+	idx_t depth = 0;
+	bool top_level_alternation = false;
+	while (pos < end) {
+		char c = pattern[pos];
+		switch (c) {
+		case '\\':
+			if (pos + 1 >= end || !AppendRegexEscape(body, pattern[pos + 1], false)) {
+				return false;
+			}
+			pos += 2;
+			break;
+		case '[':
+			if (!AppendRegexClass(body, pattern, pos, end)) {
+				return false;
+			}
+			break;
+		case '(':
+			pos++;
+			if (pos < end && pattern[pos] == '?') {
+				// Non-capturing (?:...) and named (?P<name>...) or (?<name>...) groups are plain groups in Lucene.
+				if (pattern.compare(pos, 2, "?:") == 0) {
+					pos += 2;
+				} else if (pattern.compare(pos, 3, "?P<") == 0 || pattern.compare(pos, 2, "?<") == 0) {
+					auto name_end = pattern.find('>', pos);
+					if (name_end == string::npos || name_end >= end) {
+						return false;
+					}
+					pos = name_end + 1;
+				} else {
+					return false;
+				}
+			}
+			body += '(';
+			depth++;
+			break;
+		case ')':
+			if (depth == 0) {
+				return false;
+			}
+			body += ')';
+			depth--;
+			pos++;
+			break;
+		case '|':
+			if (depth == 0) {
+				top_level_alternation = true;
+			}
+			body += '|';
+			pos++;
+			break;
+		case '.':
+			body += '.';
+			pos++;
+			break;
+		case '*':
+		case '+':
+		case '?':
+		case '{': {
+			if (body.empty() || body.back() == '(' || body.back() == '|') {
+				return false;
+			}
+			if (c == '{') {
+				// {n}, {n,} or {n,m} - anything else is a literal brace in RE2, which is not worth the ambiguity.
+				auto close = pattern.find('}', pos);
+				if (close == string::npos || close >= end) {
+					return false;
+				}
+				string repeat = pattern.substr(pos + 1, close - pos - 1);
+				auto comma = repeat.find(',');
+				string min = repeat.substr(0, comma);
+				string max = comma == string::npos ? "" : repeat.substr(comma + 1);
+				auto is_digit = [](char d) {
+					return StringUtil::CharacterIsDigit(d);
+				};
+				if (min.empty() || !std::all_of(min.begin(), min.end(), is_digit) ||
+				    !std::all_of(max.begin(), max.end(), is_digit)) {
+					return false;
+				}
+				body += pattern.substr(pos, close - pos + 1);
+				pos = close + 1;
+			} else {
+				body += c;
+				pos++;
+			}
+			// Lazy quantifiers match the same values as greedy ones.
+			if (pos < end && pattern[pos] == '?') {
+				pos++;
+			}
+			break;
+		}
+		case '^':
+		case '$':
+			return false;
+		default:
+			AppendLuceneLiteral(body, c);
+			pos++;
+			break;
+		}
+	}
+	if (depth != 0 || body.empty()) {
+		return false;
+	}
+	// ^a|b anchors only the first alternative.
+	if (top_level_alternation && (anchored_start || anchored_end)) {
+		return false;
+	}
+
+	if (!partial_match || (anchored_start && anchored_end)) {
+		lucene_pattern = body;
+		return true;
+	}
+	lucene_pattern = anchored_start ? "" : ".*";
+	lucene_pattern += "(" + body + ")";
+	lucene_pattern += anchored_end ? "" : ".*";
+	return true;
+}
+
+// Translate an RE2 regular expression match into a regexp query. regexp_matches and regexp_full_match are
+// evaluated on the raw value, so only keyword fields and text fields with a .keyword subfield qualify.
+// {"regexp": {"field": {"value": "pattern"}}} or with case_insensitive option
+static yyjson_mut_val *TranslateRegexpMatch(yyjson_mut_doc *doc, const string &field_name, const string &pattern,
+                                            bool partial_match, bool case_insensitive,
+                                            const ElasticsearchSchema &schema) {
+	bool is_text_field = schema.text_fields.count(field_name) > 0;
+	bool has_keyword_subfield = schema.text_fields_with_keyword.count(field_name) > 0;
+	if (is_text_field && !has_keyword_subfield) {
+		return nullptr;
+	}
+
+	string lucene_pattern;
+	if (!TranslateRegexToLucene(pattern, partial_match, lucene_pattern, case_insensitive)) {
+		return nullptr;
+	}
+
+	string es_field = GetPatternFieldName(field_name, schema);
+	yyjson_mut_val *regexp_value = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, regexp_value, "value", lucene_pattern.c_str());
+	if (case_insensitive) {
+		yyjson_mut_obj_add_bool(doc, regexp_value, "case_insensitive", true);
+	}
+
+	yyjson_mut_val *regexp_inner = yyjson_mut_obj(doc);
+	yyjson_mut_val *field_key = yyjson_mut_strcpy(doc, es_field.c_str());
+	yyjson_mut_obj_add(regexp_inner, field_key, regexp_value);
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "regexp", regexp_inner);
+	return result;
+}
+
+// Translate a full-text predicate into a match, match_phrase or query_string query. The field is used as is (not
+// its .keyword subfield), so the query text goes through the analyzer of the field.
+static yyjson_mut_val *TranslateFullTextPredicate(yyjson_mut_doc *doc, const string &func_name,
+                                                  const string &field_name, const string &query_text) {
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	if (func_name == "es_query_string") {
+		yyjson_mut_val *query_string = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_strcpy(doc, query_string, "query", query_text.c_str());
+		yyjson_mut_obj_add_strcpy(doc, query_string, "default_field", field_name.c_str());
+		yyjson_mut_obj_add_val(doc, result, "query_string", query_string);
+		return result;
+	}
+
+	yyjson_mut_val *match_value = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, match_value, "query", query_text.c_str());
+
+	yyjson_mut_val *match_inner = yyjson_mut_obj(doc);
+	yyjson_mut_val *field_key = yyjson_mut_strcpy(doc, field_name.c_str());
+	yyjson_mut_obj_add(match_inner, field_key, match_value);
+
+	yyjson_mut_obj_add_val(doc, result, func_name == "es_match" ? "match" : "match_phrase", match_inner);
+	return result;
+}
+
+bool ExtractDatePart(const Expression &expr, string &part) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	if (func_expr.children.empty()) {
+		return false;
+	}
+
+	// Both the part functions (year(col), hour(col)) and date_part('part', col) / extract(part FROM col). Only
+	// date_part accepts the abbreviations.
+	static const std::unordered_map<string, string> parts = {
+	    {"year", "year"},           {"years", "year"},          {"y", "year"},
+	    {"yr", "year"},             {"quarter", "quarter"},     {"quarters", "quarter"},
+	    {"month", "month"},         {"months", "month"},        {"mon", "month"},
+	    {"day", "day"},             {"days", "day"},            {"d", "day"},
+	    {"dayofmonth", "day"},      {"dayofyear", "dayofyear"}, {"doy", "dayofyear"},
+	    {"dayofweek", "dayofweek"}, {"dow", "dayofweek"},       {"weekday", "dayofweek"},
+	    {"isodow", "isodow"},       {"hour", "hour"},           {"hours", "hour"},
+	    {"h", "hour"},              {"hr", "hour"},             {"minute", "minute"},
+	    {"minutes", "minute"},      {"min", "minute"},          {"second", "second"},
+	    {"seconds", "second"},      {"s", "second"},            {"sec", "second"}};
+	static const std::set<string> part_functions = {"year",      "quarter", "month",   "day",    "dayofmonth",
+	                                                "dayofyear", "dayofweek", "weekday", "isodow", "hour",
+	                                                "minute",    "second"};
+	string specifier;
+	if (func_expr.function.name == "date_part" || func_expr.function.name == "datepart") {
+		if (func_expr.children.size() != 2 || !ExtractConstantString(*func_expr.children[0], specifier)) {
+			return false;
+		}
+		specifier = StringUtil::Lower(specifier);
+	} else if (func_expr.children.size() == 1 && part_functions.count(func_expr.function.name) > 0) {
+		specifier = func_expr.function.name;
+	} else {
+		return false;
+	}
+
+	auto entry = parts.find(specifier);
+	if (entry == parts.end()) {
+		return false;
+	}
+	part = entry->second;
+	return true;
+}
+
+// Append an interval to Elasticsearch date math, e.g. -15m for INTERVAL 15 MINUTE subtracted. Date math has no
+// unit below seconds, so intervals with fractional seconds cannot be appended.
+static bool AppendDateMathInterval(string &date_math, interval_t interval, bool subtract) {
+	if (interval.micros % Interval::MICROS_PER_SEC != 0) {
+		return false;
+	}
+	auto append = [&](int64_t amount, const char *unit) {
+		if (amount == 0) {
+			return;
+		}
+		if (subtract) {
+			amount = -amount;
+		}
+		date_math += (amount < 0 ? "-" : "+") + to_string(amount < 0 ? -amount : amount) + unit;
+	};
+	// Months, then days, then the time, in the order DuckDB adds them.
+	if (interval.months % Interval::MONTHS_PER_YEAR == 0) {
+		append(interval.months / Interval::MONTHS_PER_YEAR, "y");
+	} else {
+		append(interval.months, "M");
+	}
+	append(interval.days, "d");
+	if (interval.micros % Interval::MICROS_PER_HOUR == 0) {
+		append(interval.micros / Interval::MICROS_PER_HOUR, "h");
+	} else if (interval.micros % Interval::MICROS_PER_MINUTE == 0) {
+		append(interval.micros / Interval::MICROS_PER_MINUTE, "m");
+	} else {
+		append(interval.micros / Interval::MICROS_PER_SEC, "s");
+	}
+	return true;
+}
+
+bool ExtractDateMath(const Expression &expr, string &date_math, bool &rounded) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+		auto &cast_expr = expr.Cast<BoundCastExpression>();
+		auto target_type = cast_expr.return_type.id();
+		if (target_type != LogicalTypeId::TIMESTAMP && target_type != LogicalTypeId::TIMESTAMP_TZ &&
+		    target_type != LogicalTypeId::DATE) {
+			return false;
+		}
+		if (!ExtractDateMath(*cast_expr.child, date_math, rounded)) {
+			return false;
+		}
+		if (target_type == LogicalTypeId::DATE && cast_expr.child->return_type.id() != LogicalTypeId::DATE) {
+			date_math += "/d";
+			rounded = true;
+		}
+		return true;
+	}
+
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto &func_name = func_expr.function.name;
+
+	if (func_expr.children.empty()) {
+		if (func_name == "now" || func_name == "get_current_timestamp" || func_name == "current_timestamp" ||
+		    func_name == "transaction_timestamp" || func_name == "current_localtimestamp") {
+			date_math = "now";
+			rounded = false;
+			return true;
+		}
+		if (func_name == "current_date" || func_name == "today") {
+			date_math = "now/d";
+			rounded = true;
+			return true;
+		}
+		return false;
+	}
+
+	// date_trunc('unit', time) -> time/unit. Date math has no quarter rounding.
+	if ((func_name == "date_trunc" || func_name == "datetrunc") && func_expr.children.size() == 2) {
+		string unit;
+		if (!ExtractConstantString(*func_expr.children[0], unit)) {
+			return false;
+		}
+		static const std::unordered_map<string, string> units = {
+		    {"year", "y"},   {"years", "y"}, {"month", "M"},  {"months", "M"},  {"week", "w"},      {"weeks", "w"},
+		    {"day", "d"},    {"days", "d"},  {"hour", "h"},   {"hours", "h"},   {"minute", "m"},    {"minutes", "m"},
+		    {"second", "s"}, {"seconds", "s"}};
+		auto es_unit = units.find(StringUtil::Lower(unit));
+		if (es_unit == units.end() || !ExtractDateMath(*func_expr.children[1], date_math, rounded)) {
+			return false;
+		}
+		date_math += "/" + es_unit->second;
+		rounded = true;
+		return true;
+	}
+
+	// time + INTERVAL, INTERVAL + time and time - INTERVAL, or a number of days added to or subtracted from a date.
+	if ((func_name == "+" || func_name == "-") && func_expr.children.size() == 2) {
+		bool time_on_left = func_name == "-" || func_expr.children[1]->GetExpressionClass() ==
+		                                            ExpressionClass::BOUND_CONSTANT;
+		auto &time_expr = *func_expr.children[time_on_left ? 0 : 1];
+		auto &amount_expr = *func_expr.children[time_on_left ? 1 : 0];
+		if (amount_expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+			return false;
+		}
+		Value amount = amount_expr.Cast<BoundConstantExpression>().value;
+		if (amount.IsNull()) {
+			return false;
+		}
+		interval_t interval;
+		if (amount.type().id() == LogicalTypeId::INTERVAL) {
+			interval = IntervalValue::Get(amount);
+		} else if (time_expr.return_type.id() == LogicalTypeId::DATE && amount.type().IsIntegral() &&
+		           amount.DefaultTryCastAs(LogicalType::INTEGER)) {
+			interval = interval_t();
+			interval.days = IntegerValue::Get(amount);
+		} else {
+			return false;
+		}
+		if (!ExtractDateMath(time_expr, date_math, rounded)) {
+			return false;
+		}
+		return AppendDateMathInterval(date_math, interval, func_name == "-");
+	}
+
+	return false;
+}
+
+// lower(col), upper(col) and their aliases lcase and ucase.
+bool ExtractCaseConversion(const Expression &expr, bool &upper) {
+	if (expr.type != ExpressionType::BOUND_FUNCTION) {
+		return false;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto &func_name = func_expr.function.name;
+	if (func_expr.children.size() != 1 ||
+	    (func_name != "lower" && func_name != "lcase" && func_name != "upper" && func_name != "ucase")) {
+		return false;
+	}
+	upper = func_name == "upper" || func_name == "ucase";
+	return true;
+}
+
+bool IsCaseConvertedValue(const Value &value, bool upper) {
+	if (value.IsNull() || value.type().id() != LogicalTypeId::VARCHAR) {
+		return false;
+	}
+	for (char c : StringValue::Get(value)) {
+		bool changed = upper ? (c >= 'a' && c <= 'z') : (c >= 'A' && c <= 'Z');
+		if (static_cast<unsigned char>(c) >= 0x80 || changed) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Translate a case-insensitive match of a field with any of the values. A keyword subfield with the lowercase
+// normalizer normalizes the query terms too, so a term or terms query on it suffices:
+// {"terms": {"field.lowercase": [values]}}. Otherwise the term queries are case-insensitive, which terms queries
+// don't support: {"term": {"field": {"value": value, "case_insensitive": true}}}, several combined with
+// bool.should.
+static yyjson_mut_val *TranslateCaseInsensitiveTerms(yyjson_mut_doc *doc, const vector<Value> &values,
+                                                     const string &field_name, const ElasticsearchSchema &schema) {
+	auto lowercase_subfield = schema.lowercase_subfields.find(field_name);
+	if (lowercase_subfield != schema.lowercase_subfields.end()) {
+		if (values.size() == 1) {
+			ConstantFilter equal_filter(ExpressionType::COMPARE_EQUAL, values[0]);
+			return TranslateConstantComparison(doc, equal_filter, lowercase_subfield->second, schema);
+		}
+		InFilter in_filter(values);
+		return TranslateInFilter(doc, in_filter, lowercase_subfield->second, schema);
+	}
+
+	bool is_text_field = schema.text_fields.count(field_name) > 0;
+	bool has_keyword_subfield = schema.text_fields_with_keyword.count(field_name) > 0;
+	if (is_text_field && !has_keyword_subfield) {
+		return nullptr;
+	}
+	string es_field = GetElasticsearchFieldName(field_name, schema);
+
+	// Sort and deduplicate the values, as for IN lists.
+	vector<Value> sorted_values = values;
+	std::sort(sorted_values.begin(), sorted_values.end());
+	sorted_values.erase(std::unique(sorted_values.begin(), sorted_values.end()), sorted_values.end());
+
+	yyjson_mut_val *should_arr = yyjson_mut_arr(doc);
+	for (auto &value : sorted_values) {
+		yyjson_mut_val *term_value = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, term_value, "value", ConvertDuckDBToJSON(doc, value));
+		yyjson_mut_obj_add_bool(doc, term_value, "case_insensitive", true);
+
+		yyjson_mut_val *term_inner = yyjson_mut_obj(doc);
+		yyjson_mut_val *key = yyjson_mut_strcpy(doc, es_field.c_str());
+		yyjson_mut_obj_add(term_inner, key, term_value);
+
+		yyjson_mut_val *term = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, term, "term", term_inner);
+		yyjson_mut_arr_append(should_arr, term);
+	}
+
+	if (yyjson_mut_arr_size(should_arr) == 1) {
+		return yyjson_mut_arr_get_first(should_arr);
+	}
+
+	// {"bool": {"should": [{"term": ...}, {"term": ...}], "minimum_should_match": 1}}
+	yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, bool_obj, "should", should_arr);
+	yyjson_mut_obj_add_int(doc, bool_obj, "minimum_should_match", 1);
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "bool", bool_obj);
+	return result;
+}
+
+// Painless expression evaluating a date part (as returned by ExtractDatePart) of the first value of a date field,
+// a ZonedDateTime in UTC. Returns an empty string for unsupported parts.
+static string GetPainlessDatePart(const string &part) {
+	const string value = "doc[params.field].value";
+	if (part == "year") {
+		return value + ".getYear()";
+	}
+	if (part == "quarter") {
+		return "((" + value + ".getMonthValue() - 1) / 3 + 1)";
+	}
+	if (part == "month") {
+		return value + ".getMonthValue()";
+	}
+	if (part == "day") {
+		return value + ".getDayOfMonth()";
+	}
+	if (part == "dayofyear") {
+		return value + ".getDayOfYear()";
+	}
+	if (part == "dayofweek") {
+		// DuckDB counts from Sunday (0), java.time from Monday (1) to Sunday (7).
+		return "(" + value + ".getDayOfWeek().getValue() % 7)";
+	}
+	if (part == "isodow") {
+		return value + ".getDayOfWeek().getValue()";
+	}
+	if (part == "hour") {
+		return value + ".getHour()";
+	}
+	if (part == "minute") {
+		return value + ".getMinute()";
+	}
+	if (part == "second") {
+		return value + ".getSecond()";
+	}
+	return "";
+}
+
+// Build a script query: {"script": {"script": {"source": "...", "params": {...}}}}
+static yyjson_mut_val *TranslateScript(yyjson_mut_doc *doc, const string &source, const child_list_t<Value> &params) {
+	yyjson_mut_val *params_obj = yyjson_mut_obj(doc);
+	for (auto &param : params) {
+		yyjson_mut_val *param_key = yyjson_mut_strcpy(doc, param.first.c_str());
+		yyjson_mut_obj_add(params_obj, param_key, ConvertDuckDBToJSON(doc, param.second));
+	}
+
+	yyjson_mut_val *script = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_strcpy(doc, script, "source", source.c_str());
+	yyjson_mut_obj_add_val(doc, script, "params", params_obj);
+
+	yyjson_mut_val *script_inner = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, script_inner, "script", script);
+
+	yyjson_mut_val *result = yyjson_mut_obj(doc);
+	yyjson_mut_obj_add_val(doc, result, "script", script_inner);
+	return result;
+}
+
+// Translate a comparison or BETWEEN of a date part against integer constants into a script query:
+// {"script": {"script": {"source": "doc[params.field].size() != 0 && ... >= params.v0", "params": {...}}}}
+// Documents without the field do not match, as the comparison is NULL for them.
+static yyjson_mut_val *TranslateDatePartScript(yyjson_mut_doc *doc, const Expression &expr, const string &field_name) {
+	// Pairs of the Painless operator and the constant it is compared to.
+	vector<std::pair<string, const Expression *>> conditions;
+	const Expression *part_expr;
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+		auto &between_expr = expr.Cast<BoundBetweenExpression>();
+		part_expr = between_expr.input.get();
+		conditions.emplace_back(between_expr.lower_inclusive ? ">=" : ">", between_expr.lower.get());
+		conditions.emplace_back(between_expr.upper_inclusive ? "<=" : "<", between_expr.upper.get());
+	} else {
+		auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+		part_expr = comp_expr.left.get();
+		switch (comp_expr.GetExpressionType()) {
+		case ExpressionType::COMPARE_EQUAL:
+			conditions.emplace_back("==", comp_expr.right.get());
+			break;
+		case ExpressionType::COMPARE_NOTEQUAL:
+			conditions.emplace_back("!=", comp_expr.right.get());
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			conditions.emplace_back(">", comp_expr.right.get());
+			break;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			conditions.emplace_back(">=", comp_expr.right.get());
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+			conditions.emplace_back("<", comp_expr.right.get());
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			conditions.emplace_back("<=", comp_expr.right.get());
+			break;
+		default:
+			return nullptr;
+		}
+	}
+
+	string part;
+	if (!ExtractDatePart(*part_expr, part)) {
+		return nullptr;
+	}
+	string painless_part = GetPainlessDatePart(part);
+	if (painless_part.empty()) {
+		return nullptr;
+	}
+
+	child_list_t<Value> params;
+	params.emplace_back("field", Value(field_name));
+	string source = "doc[params.field].size() != 0";
+	for (idx_t i = 0; i < conditions.size(); i++) {
+		if (conditions[i].second->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+			return nullptr;
+		}
+		Value constant = conditions[i].second->Cast<BoundConstantExpression>().value;
+		if (constant.IsNull() || !constant.DefaultTryCastAs(LogicalType::BIGINT)) {
+			return nullptr;
+		}
+		string param_name = "v" + to_string(i);
+		source += " && " + painless_part + " " + conditions[i].first + " params." + param_name;
+		params.emplace_back(param_name, std::move(constant));
+	}
+	return TranslateScript(doc, source, params);
+}
+
 // Try to extract a constant GeoJSON string from a spatial expression.
 // Recognizes:
 // - BoundConstantExpression with VARCHAR type -> treat as GeoJSON string directly
@@ -1,14 +1,189 @@
 #include "elasticsearch_optimizer.hpp"
+#include "elasticsearch_aggregate_pushdown.hpp"
+#include "elasticsearch_common.hpp"
 #include "elasticsearch_query.hpp"
+#include "duckdb/common/string_util.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
+#include "duckdb/planner/expression/bound_columnref_expression.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckdb/planner/operator/logical_empty_result.hpp"
 #include "duckdb/planner/operator/logical_limit.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_order.hpp"
 #include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_top_n.hpp"
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/planner/table_filter_set.hpp"
 
+#include <unordered_set>
+
 namespace duckdb {
 
+// Shared helpers for the plan rewrites that replace operators above an elasticsearch_query scan.
+
+bool MatchElasticsearchScan(LogicalOperator &op, ElasticsearchScanMatch &match) {
+	reference<LogicalOperator> current = op;
+	while (current.get().type == LogicalOperatorType::LOGICAL_PROJECTION) {
+		if (current.get().children.empty()) {
+			return false;
+		}
+		match.projections.push_back(current.get().Cast<LogicalProjection>());
+		current = *current.get().children[0];
+	}
+	if (current.get().type != LogicalOperatorType::LOGICAL_GET) {
+		return false;
+	}
+	auto &get = current.get().Cast<LogicalGet>();
+	if (get.function.name != "elasticsearch_query" || !get.bind_data) {
+		return false;
+	}
+	match.get = &get;
+	return true;
+}
+
+bool InlineProjections(unique_ptr<Expression> &expr, const ElasticsearchScanMatch &match) {
+	if (expr->GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		auto &col_ref = expr->Cast<BoundColumnRefExpression>();
+		if (col_ref.binding.table_index == match.get->table_index ||
+		    (match.unnest && col_ref.binding.table_index == match.unnest->unnest_index)) {
+			return true;
+		}
+		for (auto &projection : match.projections) {
+			if (col_ref.binding.table_index != projection.get().table_index) {
+				continue;
+			}
+			idx_t column_idx = col_ref.binding.column_index.GetIndexUnsafe();
+			if (column_idx >= projection.get().expressions.size()) {
+				return false;
+			}
+			expr = projection.get().expressions[column_idx]->Copy();
+			return InlineProjections(expr, match);
+		}
+		return false;
+	}
+
+	bool success = true;
+	ExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<Expression> &child) {
+		if (success && !InlineProjections(child, match)) {
+			success = false;
+		}
+	});
+	return success;
+}
+
+bool ResolveElasticsearchColumnId(const Expression &expr, const ElasticsearchScanMatch &match, idx_t &col_id) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COLUMN_REF) {
+		return false;
+	}
+	auto &col_ref = expr.Cast<BoundColumnRefExpression>();
+	if (col_ref.binding.table_index != match.get->table_index) {
+		return false;
+	}
+
+	// With filter pruning, bindings refer to projection_ids, which in turn index column_ids.
+	idx_t column_pos = col_ref.binding.column_index.GetIndexUnsafe();
+	auto &projection_ids = match.get->projection_ids;
+	if (!projection_ids.empty()) {
+		if (column_pos >= projection_ids.size()) {
+			return false;
+		}
+		column_pos = projection_ids[column_pos];
+	}
+	auto &column_ids = match.get->GetColumnIds();
+	if (column_pos >= column_ids.size()) {
+		return false;
+	}
+	col_id = column_ids[column_pos].GetPrimaryIndex();
+	return true;
+}
+
+bool ResolveElasticsearchField(const Expression &expr, const ElasticsearchScanMatch &match,
+                               ElasticsearchFieldRef &result) {
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+
+	// Direct column reference: map the binding to the bind schema column.
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		// Below an UNNEST of a nested field, the UNNEST output is a nested document. Fields of the parent
+		// documents are not in the scope of a nested aggregation.
+		if (match.unnest) {
+			auto &col_ref = expr.Cast<BoundColumnRefExpression>();
+			if (col_ref.binding.table_index != match.unnest->unnest_index) {
+				return false;
+			}
+			result.path = match.nested_path;
+			result.es_type = "nested";
+			result.type = col_ref.return_type;
+			return true;
+		}
+		// Column layout: [_id (0), ...fields... (1 to N), _unmapped_ (N+1)].
+		idx_t col_id;
+		if (!ResolveElasticsearchColumnId(expr, match, col_id) || col_id == 0 ||
+		    col_id > bind_data.schema.field_paths.size()) {
+			return false;
+		}
+		result.path = bind_data.schema.field_paths[col_id - 1];
+		result.es_type = bind_data.schema.es_types[col_id - 1];
+		result.type = bind_data.schema.column_types[col_id - 1];
+		return true;
+	}
+
+	// struct_extract chain for object fields (e.g. employee.address.city).
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+		auto &func_expr = expr.Cast<BoundFunctionExpression>();
+		if (func_expr.function.name != "struct_extract" || func_expr.children.size() != 2) {
+			return false;
+		}
+		string field_name;
+		if (!ExtractConstantString(*func_expr.children[1], field_name)) {
+			return false;
+		}
+		ElasticsearchFieldRef parent;
+		if (!ResolveElasticsearchField(*func_expr.children[0], match, parent) ||
+		    parent.type.id() != LogicalTypeId::STRUCT) {
+			return false;
+		}
+		result.path = parent.path + "." + field_name;
+		auto it = bind_data.schema.es_type_map.find(result.path);
+		result.es_type = it != bind_data.schema.es_type_map.end() ? it->second : "";
+		result.type = func_expr.return_type;
+		return true;
+	}
+
+	return false;
+}
+
+string GetDocValueField(const ElasticsearchFieldRef &field, const ElasticsearchSchema &schema) {
+	// Multi-valued fields would produce one bucket (or sort value) per element instead of per document.
+	auto type_id = field.type.id();
+	if (type_id == LogicalTypeId::LIST || type_id == LogicalTypeId::STRUCT || type_id == LogicalTypeId::GEOMETRY) {
+		return "";
+	}
+
+	// Text fields are analyzed and have no doc values, use the keyword subfield (.keyword) if there is one.
+	string doc_value_field;
+	if (field.es_type == "text") {
+		auto keyword_subfield = schema.keyword_subfields.find(field.path);
+		if (keyword_subfield != schema.keyword_subfields.end() && schema.text_fields_with_keyword.count(field.path)) {
+			doc_value_field = keyword_subfield->second;
+		}
+	} else {
+		static const std::unordered_set<string> doc_value_types = {
+		    "keyword", "constant_keyword", "long", "integer", "short", "byte",    "double",
+		    "float",   "half_float",       "scaled_float", "boolean", "date", "ip"};
+		if (doc_value_types.count(field.es_type) > 0) {
+			doc_value_field = field.path;
+		}
+	}
+
+	// Values longer than ignore_above have no doc values: they would sort as missing and be merged into the
+	// missing bucket of aggregations. Doc values of normalized keywords are the normalized terms, not the values.
+	if (schema.ignore_above_fields.count(doc_value_field) > 0 || schema.normalized_fields.count(doc_value_field) > 0) {
+		return "";
+	}
+	return doc_value_field;
+}
+
 // In Elasticsearch, the _id metadata field is always non-null: every document has an _id.
 // This lets us optimize filters on _id at compile time:
 //
@@ -63,6 +238,138 @@ static void OptimizeIdFilters(unique_ptr<LogicalOperator> &op) {
 	}
 }
 
+// Translate ORDER BY keys over an elasticsearch_query scan into Elasticsearch sort keys.
+// Every key must be the _score virtual column or a field with doc values whose sort order matches DuckDB's: ip
+// fields sort by address and half_float/scaled_float doc values are rounded, so they could select different rows
+// than DuckDB would. Keyword fields with ignore_above have no doc value field (see GetDocValueField).
+bool TranslateSortKeys(const vector<BoundOrderByNode> &orders, const ElasticsearchScanMatch &match,
+                       vector<ElasticsearchSortKey> &sort) {
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	for (auto &order : orders) {
+		auto expr = order.expression->Copy();
+		if (!InlineProjections(expr, match)) {
+			return false;
+		}
+		// Relevance ranking: ORDER BY _score DESC.
+		idx_t col_id;
+		if (ResolveElasticsearchColumnId(*expr, match, col_id) && col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+			ElasticsearchSortKey key;
+			key.field = "_score";
+			key.descending = order.type == OrderType::DESCENDING;
+			sort.push_back(std::move(key));
+			continue;
+		}
+		ElasticsearchFieldRef field;
+		if (!ResolveElasticsearchField(*expr, match, field)) {
+			return false;
+		}
+		if (field.es_type == "ip" || field.es_type == "half_float" || field.es_type == "scaled_float") {
+			return false;
+		}
+		ElasticsearchSortKey key;
+		key.field = GetDocValueField(field, bind_data.schema);
+		if (key.field.empty()) {
+			return false;
+		}
+		key.descending = order.type == OrderType::DESCENDING;
+		key.nulls_first = order.null_order == OrderByNullType::NULLS_FIRST;
+		sort.push_back(std::move(key));
+	}
+	return !sort.empty();
+}
+
+// Push ORDER BY keys and limit + offset into an elasticsearch_query scan below op (PROJECTION* -> GET).
+// The scan then returns only the first limit + offset documents in sort order.
+static bool TryPushdownTopN(LogicalOperator &op, const vector<BoundOrderByNode> &orders, idx_t limit,
+                            idx_t offset) {
+	ElasticsearchScanMatch match;
+	if (!MatchElasticsearchScan(op, match)) {
+		return false;
+	}
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	if (bind_data.limit >= 0 || bind_data.offset > 0 || !bind_data.sort.empty()) {
+		return false;
+	}
+	vector<ElasticsearchSortKey> sort;
+	if (limit + offset == 0 || !TranslateSortKeys(orders, match, sort)) {
+		return false;
+	}
+	bind_data.sort = std::move(sort);
+	SetElasticsearchLimitOffset(bind_data, static_cast<int64_t>(limit + offset), 0);
+	return true;
+}
+
+// Walks the plan tree looking for TOP_N operators (or LIMIT over ORDER BY) directly above an
+// elasticsearch_query scan (with optional intermediate PROJECTION nodes). When the sort keys are
+// sortable fields, the sort and limit + offset are stored in the bind data, so Elasticsearch
+// sorts and returns only the rows that can make it into the result. The TOP_N (or ORDER BY and
+// LIMIT) operators stay in the plan and apply the exact ordering and offset to those rows.
+static void OptimizeTopNPushdown(unique_ptr<LogicalOperator> &op) {
+	if (op->type == LogicalOperatorType::LOGICAL_TOP_N) {
+		auto &top_n = op->Cast<LogicalTopN>();
+		if (TryPushdownTopN(*op->children[0], top_n.orders, top_n.limit, top_n.offset)) {
+			return;
+		}
+	} else if (op->type == LogicalOperatorType::LOGICAL_LIMIT &&
+	           op->children[0]->type == LogicalOperatorType::LOGICAL_ORDER_BY) {
+		auto &limit_op = op->Cast<LogicalLimit>();
+		auto &order = op->children[0]->Cast<LogicalOrder>();
+		if (limit_op.limit_val.Type() == LimitNodeType::CONSTANT_VALUE &&
+		    (limit_op.offset_val.Type() == LimitNodeType::CONSTANT_VALUE ||
+		     limit_op.offset_val.Type() == LimitNodeType::UNSET)) {
+			idx_t offset = limit_op.offset_val.Type() == LimitNodeType::CONSTANT_VALUE
+			                   ? limit_op.offset_val.GetConstantValue()
+			                   : 0;
+			if (TryPushdownTopN(*order.children[0], order.orders, limit_op.limit_val.GetConstantValue(), offset)) {
+				return;
+			}
+		}
+	}
+
+	for (auto &child : op->children) {
+		OptimizeTopNPushdown(child);
+	}
+}
+
+// Push the keys of an ORDER BY without LIMIT into the elasticsearch_query scan below it (PROJECTION* -> GET).
+// The scan is single-threaded and the scroll keeps the sort order across batches, so it returns the rows in the
+// order of the ORDER BY. Like for Top-N, keys on fields with ignore_above are not pushed (see TranslateSortKeys).
+static bool TryPushdownOrder(LogicalOrder &order) {
+	ElasticsearchScanMatch match;
+	if (!MatchElasticsearchScan(*order.children[0], match)) {
+		return false;
+	}
+	auto &bind_data = match.get->bind_data->Cast<ElasticsearchQueryBindData>();
+	if (bind_data.limit >= 0 || bind_data.offset > 0 || !bind_data.sort.empty()) {
+		return false;
+	}
+	vector<ElasticsearchSortKey> sort;
+	if (!TranslateSortKeys(order.orders, match, sort)) {
+		return false;
+	}
+	bind_data.sort = std::move(sort);
+	return true;
+}
+
+// Walks the plan tree looking for ORDER BY operators without LIMIT directly above an elasticsearch_query scan
+// (with optional intermediate PROJECTION nodes). When the sort keys can be pushed, the scan returns the rows in
+// sort order and the ORDER BY operator is removed, so large ordered results are streamed instead of sorted
+// locally. An ORDER BY that projects out columns is only removed below a PROJECTION, which references its
+// columns explicitly, so the extra scan columns do not reach the result.
+static void OptimizeOrderPushdown(unique_ptr<LogicalOperator> &op, bool below_projection = false) {
+	if (op->type == LogicalOperatorType::LOGICAL_ORDER_BY) {
+		auto &order = op->Cast<LogicalOrder>();
+		if ((order.projection_map.empty() || below_projection) && TryPushdownOrder(order)) {
+			op = std::move(op->children[0]);
+			return;
+		}
+	}
+
+	for (auto &child : op->children) {
+		OptimizeOrderPushdown(child, op->type == LogicalOperatorType::LOGICAL_PROJECTION);
+	}
+}
+
 // Walks the plan tree looking for LIMIT operators directly above an elasticsearch_query scan
 // (with optional intermediate PROJECTION nodes). When found, the constant limit and offset
 // values are stored in the bind data and the LIMIT operator is removed from the plan so that
@@ -136,6 +443,9 @@ static void OptimizeLimitPushdown(unique_ptr<LogicalOperator> &op) {
 
 void OptimizeElasticsearchPlan(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan) {
 	OptimizeIdFilters(plan);
+	OptimizeAggregatePushdown(input, plan);
+	OptimizeTopNPushdown(plan);
+	OptimizeOrderPushdown(plan);
 	OptimizeLimitPushdown(plan);
 }
 
@@ -3,6 +3,7 @@
 #include "elasticsearch_filter_pushdown.hpp"
 #include "elasticsearch_schema.hpp"
 #include "duckdb/function/table_function.hpp"
+#include "duckdb/function/scalar_function.hpp"
 #include "duckdb/common/types/data_chunk.hpp"
 #include "duckdb/main/settings.hpp"
 #include "duckdb/main/client_config.hpp"
@@ -11,6 +12,7 @@
 #include "duckdb/planner/filter/null_filter.hpp"
 #include "duckdb/planner/filter/in_filter.hpp"
 #include "duckdb/planner/filter/constant_filter.hpp"
+#include "duckdb/planner/filter/conjunction_filter.hpp"
 #include "duckdb/planner/filter/expression_filter.hpp"
 #include "duckdb/planner/filter/struct_filter.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
@@ -19,11 +21,19 @@
 #include "duckdb/planner/expression/bound_constant_expression.hpp"
 #include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "duckdb/planner/expression/bound_comparison_expression.hpp"
+#include "duckdb/planner/expression/bound_conjunction_expression.hpp"
+#include "duckdb/planner/expression/bound_between_expression.hpp"
+#include "duckdb/planner/expression/bound_cast_expression.hpp"
+#include "duckdb/planner/expression/bound_case_expression.hpp"
+#include "duckdb/planner/expression/bound_reference_expression.hpp"
+#include "duckdb/function/lambda_functions.hpp"
+#include "duckdb/planner/expression_iterator.hpp"
 #include "duckdb/execution/expression_executor.hpp"
 #include "duckdb/common/string_util.hpp"
 #include "yyjson.hpp"
 
 #include <algorithm>
+#include <cmath>
 #include <functional>
 #include <set>
 
@@ -31,35 +41,6 @@ namespace duckdb {
 
 using namespace duckdb_yyjson;
 
-// Bind data for the elasticsearch_query function.
-struct ElasticsearchQueryBindData : public TableFunctionData {
-	ElasticsearchConfig config;
-	std::string index;
-	std::string base_query; // user-provided query (optional, merged with filters)
-
-	// Logger for HTTP request logging, captured from ClientContext during bind.
-	shared_ptr<Logger> logger;
-
-	// Resolved Elasticsearch schema containing all mapping and sampling information.
-	// Produced by ResolveElasticsearchSchema() and consumed by query building, filter pushdown and scanning.
-	ElasticsearchSchema schema;
-
-	// Sample size for array detection (0 = disabled).
-	// Populated from elasticsearch_sample_size setting, overridable by named parameter.
-	int64_t sample_size;
-
-	// Scroll and batch settings.
-	// Populated from extension settings, not overridable by named parameters.
-	int64_t batch_size;                  // from elasticsearch_batch_size
-	int64_t batch_size_threshold_factor; // from elasticsearch_batch_size_threshold_factor
-	std::string scroll_time;             // from elasticsearch_scroll_time
-
-	// Limit pushdown values (set by optimizer extension).
-	// -1 means no limit, 0 means no offset.
-	int64_t limit = -1;
-	int64_t offset = 0;
-};
-
 // Projected subset of schema information for the columns actually needed during scanning.
 // Built during init from the full ElasticsearchSchema by selecting only the projected columns.
 struct ProjectedSchema {
@@ -122,19 +103,30 @@ struct ElasticsearchQueryGlobalState : public GlobalTableFunctionState {
 	}
 };
 
-// Build the final Elasticsearch query by merging base query with pushed filters and projection.
-// projection_ids contains indices into column_ids for columns that need to be in the output.
-// If projection_ids is empty, all column_ids are output columns. Otherwise, columns not in
-// projection_ids are filter-only columns and can be excluded from _source since Elasticsearch
-// handles filtering server-side.
-static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data, const TableFilterSet *filters,
-                                   const vector<idx_t> &column_ids, const vector<idx_t> &projection_ids) {
-	std::string result;
-
-	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
-	yyjson_mut_val *root = yyjson_mut_obj(doc);
-	yyjson_mut_doc_set_root(doc, root);
+// Build the sort array for the search request. Shared by the document scan (Top-N pushdown) and the top_hits
+// aggregations of the aggregate pushdown.
+yyjson_mut_val *BuildElasticsearchSort(yyjson_mut_doc *doc, const vector<ElasticsearchSortKey> &sort) {
+	yyjson_mut_val *sort_arr = yyjson_mut_arr(doc);
+	for (const auto &key : sort) {
+		yyjson_mut_val *sort_opts = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_str(doc, sort_opts, "order", key.descending ? "desc" : "asc");
+		// Every hit has a score, _score sorts do not accept "missing".
+		if (key.field != "_score") {
+			yyjson_mut_obj_add_str(doc, sort_opts, "missing", key.nulls_first ? "_first" : "_last");
+		}
+		yyjson_mut_val *sort_field = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add(sort_field, yyjson_mut_strcpy(doc, key.field.c_str()), sort_opts);
+		yyjson_mut_arr_append(sort_arr, sort_field);
+	}
+	return sort_arr;
+}
 
+// Build the query clause by merging the base query with the pushed filters.
+// Shared by the document scan (BuildFinalQuery) and the aggregate pushdown in the optimizer extension,
+// so both send exactly the same query for the same set of pushed filters.
+yyjson_mut_val *BuildElasticsearchQueryClause(yyjson_mut_doc *doc, const ElasticsearchQueryBindData &bind_data,
+                                              const TableFilterSet *filters, const vector<idx_t> &column_ids,
+                                              bool scoring) {
 	yyjson_mut_val *query_clause = nullptr;
 	yyjson_mut_val *base_query_clause = nullptr;
 
@@ -169,6 +161,9 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 				// regular field column (col_id 1 maps to column_names[0] etc.)
 				const string &name = bind_data.schema.column_names[col_id - 1];
 				filter_column_names.push_back(name);
+			} else if (col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+				// _score virtual column (filters on it are never pushed)
+				filter_column_names.push_back("_score");
 			} else {
 				// _unmapped_ column
 				filter_column_names.push_back("_unmapped_");
@@ -181,6 +176,48 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 		filter_clause = translation_result.es_query;
 	}
 
+	// Add the cross-column boolean filters pushed by pushdown_complex_filter.
+	if (!bind_data.boolean_filters.empty()) {
+		yyjson_mut_val *must_arr = yyjson_mut_arr(doc);
+		if (filter_clause) {
+			yyjson_mut_arr_append(must_arr, filter_clause);
+		}
+		for (auto &boolean_filter : bind_data.boolean_filters) {
+			yyjson_mut_val *translated = TranslateBooleanFilter(doc, *boolean_filter, bind_data.schema);
+			if (translated) {
+				yyjson_mut_arr_append(must_arr, translated);
+			}
+		}
+
+		if (yyjson_mut_arr_size(must_arr) == 1) {
+			filter_clause = yyjson_mut_arr_get_first(must_arr);
+		} else if (yyjson_mut_arr_size(must_arr) > 1) {
+			yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, bool_obj, "must", must_arr);
+			filter_clause = yyjson_mut_obj(doc);
+			yyjson_mut_obj_add_val(doc, filter_clause, "bool", bool_obj);
+		}
+	}
+
+	// Without scoring, the base query and the filter clause are combined in the filter context:
+	// {"bool": {"filter": [base_query, filter_clause]}}. Elasticsearch then neither computes relevance scores nor
+	// orders hits by them, and caches the clauses in the node query cache.
+	if (!scoring && (base_query_clause || filter_clause)) {
+		yyjson_mut_val *filter_arr = yyjson_mut_arr(doc);
+		if (base_query_clause) {
+			yyjson_mut_arr_append(filter_arr, base_query_clause);
+		}
+		if (filter_clause) {
+			yyjson_mut_arr_append(filter_arr, filter_clause);
+		}
+		yyjson_mut_val *bool_obj = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, bool_obj, "filter", filter_arr);
+
+		query_clause = yyjson_mut_obj(doc);
+		yyjson_mut_obj_add_val(doc, query_clause, "bool", bool_obj);
+		return query_clause;
+	}
+
 	// Merge base query and filter clause.
 	if (base_query_clause && filter_clause) {
 		// Both exist, combine with bool.must.
@@ -202,7 +239,21 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 		yyjson_mut_obj_add_val(doc, query_clause, "match_all", yyjson_mut_obj(doc));
 	}
 
-	yyjson_mut_obj_add_val(doc, root, "query", query_clause);
+	return query_clause;
+}
+
+// Build the final Elasticsearch query by merging base query with pushed filters and projection.
+// projection_ids contains indices into column_ids for columns that need to be in the output.
+// If projection_ids is empty, all column_ids are output columns. Otherwise, columns not in
+// projection_ids are filter-only columns and can be excluded from _source since Elasticsearch
+// handles filtering server-side.
+static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data, const TableFilterSet *filters,
+                                   const vector<idx_t> &column_ids, const vector<idx_t> &projection_ids) {
+	std::string result;
+
+	yyjson_mut_doc *doc = yyjson_mut_doc_new(nullptr);
+	yyjson_mut_val *root = yyjson_mut_obj(doc);
+	yyjson_mut_doc_set_root(doc, root);
 
 	// Add _source projection if we have specific columns.
 	// Column layout: [_id, ...fields..., _unmapped_].
@@ -230,19 +281,30 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 	}
 
 	bool needs_full_source = false;
+	bool needs_score = false;
 	for (idx_t i = 0; i < column_ids.size(); i++) {
-		// Skip filter-only columns when checking for _unmapped_.
+		// Skip filter-only columns when checking for _unmapped_ and _score.
 		if (output_column_indices.count(i) == 0) {
 			continue;
 		}
 		idx_t col_id = column_ids[i];
-		// _unmapped_ column is always at position field_paths.size() + 1 (after _id and all fields).
-		if (col_id > bind_data.schema.field_paths.size()) {
+		if (col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+			needs_score = true;
+		} else if (col_id > bind_data.schema.field_paths.size()) {
+			// _unmapped_ column is always at position field_paths.size() + 1 (after _id and all fields).
 			needs_full_source = true;
-			break;
 		}
 	}
 
+	// Relevance scores are only computed when the _score column is read or hits are sorted by it. Otherwise the
+	// query runs in the filter context.
+	bool scoring = std::find(column_ids.begin(), column_ids.end(), ELASTICSEARCH_SCORE_COLUMN_ID) != column_ids.end();
+	for (auto &key : bind_data.sort) {
+		scoring = scoring || key.field == "_score";
+	}
+	yyjson_mut_val *query_clause = BuildElasticsearchQueryClause(doc, bind_data, filters, column_ids, scoring);
+	yyjson_mut_obj_add_val(doc, root, "query", query_clause);
+
 	if (!column_ids.empty() && !needs_full_source) {
 		vector<string> source_fields;
 		for (idx_t i = 0; i < column_ids.size(); i++) {
@@ -271,6 +333,21 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 	}
 	// If needs_full_source is true, we do not set _source, so Elasticsearch returns the full document.
 
+	// Add sort from Top-N or sort pushdown. The scroll API keeps the sort order across batches.
+	// Without a sort and scores, hits are returned in index order ("sort": ["_doc"]), the cheapest order to scroll
+	// through since no hits need to be collected and ranked.
+	if (!bind_data.sort.empty()) {
+		yyjson_mut_obj_add_val(doc, root, "sort", BuildElasticsearchSort(doc, bind_data.sort));
+		// Elasticsearch skips scoring when sorting on fields, unless scores are explicitly requested.
+		if (needs_score) {
+			yyjson_mut_obj_add_bool(doc, root, "track_scores", true);
+		}
+	} else if (!scoring) {
+		yyjson_mut_val *sort_arr = yyjson_mut_arr(doc);
+		yyjson_mut_arr_add_str(doc, sort_arr, "_doc");
+		yyjson_mut_obj_add_val(doc, root, "sort", sort_arr);
+	}
+
 	// Note: We do not add "size" to the query body here. For scroll API, the batch size is controlled
 	// by the URL parameter in ScrollSearch(). Adding "size" to the body would be misleading since
 	// Elasticsearch ignores it for scroll requests.
@@ -286,40 +363,92 @@ static std::string BuildFinalQuery(const ElasticsearchQueryBindData &bind_data,
 	return result;
 }
 
-// Bind function, called to determine output schema.
-static unique_ptr<FunctionData> ElasticsearchQueryBind(ClientContext &context, TableFunctionBindInput &input,
-                                                       vector<LogicalType> &return_types, vector<string> &names) {
-	auto bind_data = make_uniq<ElasticsearchQueryBindData>();
-
-	// Capture logger from ClientContext if HTTP logging is enabled.
-	auto &client_config = ClientConfig::GetConfig(context);
-	if (client_config.enable_http_logging) {
-		bind_data->logger = context.logger;
-	}
-
+void InitElasticsearchConfig(ClientContext &context, ElasticsearchConfig &config) {
 	// Initialize defaults for parameters that are not backed by extension settings.
-	bind_data->config.host = "localhost";
-	bind_data->config.port = 9200;
-	bind_data->config.use_ssl = false;
+	config.host = "localhost";
+	config.port = 9200;
+	config.use_ssl = false;
 
 	// Initialize defaults from extension settings.
 	// These are the single source of truth for default values (registered in LoadInternal).
 	Value setting_val;
 	if (context.TryGetCurrentSetting("elasticsearch_verify_ssl", setting_val)) {
-		bind_data->config.verify_ssl = BooleanValue::Get(setting_val);
+		config.verify_ssl = BooleanValue::Get(setting_val);
 	}
 	if (context.TryGetCurrentSetting("elasticsearch_timeout", setting_val)) {
-		bind_data->config.timeout = IntegerValue::Get(setting_val);
+		config.timeout = IntegerValue::Get(setting_val);
 	}
 	if (context.TryGetCurrentSetting("elasticsearch_max_retries", setting_val)) {
-		bind_data->config.max_retries = IntegerValue::Get(setting_val);
+		config.max_retries = IntegerValue::Get(setting_val);
 	}
 	if (context.TryGetCurrentSetting("elasticsearch_retry_interval", setting_val)) {
-		bind_data->config.retry_interval = IntegerValue::Get(setting_val);
+		config.retry_interval = IntegerValue::Get(setting_val);
 	}
 	if (context.TryGetCurrentSetting("elasticsearch_retry_backoff_factor", setting_val)) {
-		bind_data->config.retry_backoff_factor = DoubleValue::Get(setting_val);
+		config.retry_backoff_factor = DoubleValue::Get(setting_val);
+	}
+
+	// Read proxy configuration from DuckDB's core settings.
+	config.proxy_host = Settings::Get<HTTPProxySetting>(context);
+	config.proxy_username = Settings::Get<HTTPProxyUsernameSetting>(context);
+	config.proxy_password = Settings::Get<HTTPProxyPasswordSetting>(context);
+}
+
+bool SetElasticsearchConfigParameter(const string &name, const Value &value, ElasticsearchConfig &config) {
+	if (name == "host") {
+		config.host = StringValue::Get(value);
+	} else if (name == "port") {
+		config.port = IntegerValue::Get(value);
+	} else if (name == "username") {
+		config.username = StringValue::Get(value);
+	} else if (name == "password") {
+		config.password = StringValue::Get(value);
+	} else if (name == "use_ssl") {
+		config.use_ssl = BooleanValue::Get(value);
+	} else if (name == "verify_ssl") {
+		config.verify_ssl = BooleanValue::Get(value);
+	} else if (name == "timeout") {
+		config.timeout = IntegerValue::Get(value);
+	} else if (name == "max_retries") {
+		config.max_retries = IntegerValue::Get(value);
+	} else if (name == "retry_interval") {
+		config.retry_interval = IntegerValue::Get(value);
+	} else if (name == "retry_backoff_factor") {
+		config.retry_backoff_factor = DoubleValue::Get(value);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void AddElasticsearchConfigParameters(TableFunction &function) {
+	function.named_parameters["host"] = LogicalType::VARCHAR;
+	function.named_parameters["port"] = LogicalType::INTEGER;
+	function.named_parameters["username"] = LogicalType::VARCHAR;
+	function.named_parameters["password"] = LogicalType::VARCHAR;
+	function.named_parameters["use_ssl"] = LogicalType::BOOLEAN;
+	function.named_parameters["verify_ssl"] = LogicalType::BOOLEAN;
+	function.named_parameters["timeout"] = LogicalType::INTEGER;
+	function.named_parameters["max_retries"] = LogicalType::INTEGER;
+	function.named_parameters["retry_interval"] = LogicalType::INTEGER;
+	function.named_parameters["retry_backoff_factor"] = LogicalType::DOUBLE;
+}
+
+// Bind function, called to determine output schema.
+static unique_ptr<FunctionData> ElasticsearchQueryBind(ClientContext &context, TableFunctionBindInput &input,
+                                                       vector<LogicalType> &return_types, vector<string> &names) {
+	auto bind_data = make_uniq<ElasticsearchQueryBindData>();
+
+	// Capture logger from ClientContext if HTTP logging is enabled.
+	auto &client_config = ClientConfig::GetConfig(context);
+	if (client_config.enable_http_logging) {
+		bind_data->logger = context.logger;
 	}
+
+	// Initialize connection defaults from extension settings.
+	InitElasticsearchConfig(context, bind_data->config);
+
+	Value setting_val;
 	if (context.TryGetCurrentSetting("elasticsearch_sample_size", setting_val)) {
 		bind_data->sample_size = IntegerValue::Get(setting_val);
 	}
@@ -335,30 +464,12 @@ static unique_ptr<FunctionData> ElasticsearchQueryBind(ClientContext &context, T
 
 	// Parse named parameters (override settings when explicitly specified).
 	for (auto &kv : input.named_parameters) {
-		if (kv.first == "host") {
-			bind_data->config.host = StringValue::Get(kv.second);
-		} else if (kv.first == "port") {
-			bind_data->config.port = IntegerValue::Get(kv.second);
+		if (SetElasticsearchConfigParameter(kv.first, kv.second, bind_data->config)) {
+			continue;
 		} else if (kv.first == "index") {
 			bind_data->index = StringValue::Get(kv.second);
 		} else if (kv.first == "query") {
 			bind_data->base_query = StringValue::Get(kv.second);
-		} else if (kv.first == "username") {
-			bind_data->config.username = StringValue::Get(kv.second);
-		} else if (kv.first == "password") {
-			bind_data->config.password = StringValue::Get(kv.second);
-		} else if (kv.first == "use_ssl") {
-			bind_data->config.use_ssl = BooleanValue::Get(kv.second);
-		} else if (kv.first == "verify_ssl") {
-			bind_data->config.verify_ssl = BooleanValue::Get(kv.second);
-		} else if (kv.first == "timeout") {
-			bind_data->config.timeout = IntegerValue::Get(kv.second);
-		} else if (kv.first == "max_retries") {
-			bind_data->config.max_retries = IntegerValue::Get(kv.second);
-		} else if (kv.first == "retry_interval") {
-			bind_data->config.retry_interval = IntegerValue::Get(kv.second);
-		} else if (kv.first == "retry_backoff_factor") {
-			bind_data->config.retry_backoff_factor = DoubleValue::Get(kv.second);
 		} else if (kv.first == "sample_size") {
 			bind_data->sample_size = IntegerValue::Get(kv.second);
 		}
@@ -372,11 +483,6 @@ static unique_ptr<FunctionData> ElasticsearchQueryBind(ClientContext &context, T
 		throw InvalidInputException("elasticsearch_query requires 'index' parameter");
 	}
 
-	// Read proxy configuration from DuckDB's core settings.
-	bind_data->config.proxy_host = Settings::Get<HTTPProxySetting>(context);
-	bind_data->config.proxy_username = Settings::Get<HTTPProxyUsernameSetting>(context);
-	bind_data->config.proxy_password = Settings::Get<HTTPProxyPasswordSetting>(context);
-
 	// Resolve schema from Elasticsearch (mapping + document sampling), with caching.
 	// On cache hit, no HTTP requests are made. On cache miss, the mapping is fetched and
 	// documents are sampled to detect arrays and unmapped fields.
@@ -435,6 +541,11 @@ static unique_ptr<GlobalTableFunctionState> ElasticsearchQueryInitGlobal(ClientC
 				state->projected.field_paths.push_back(bind_data.schema.field_paths[field_idx]);
 				state->projected.es_types.push_back(bind_data.schema.es_types[field_idx]);
 				state->projected.column_types.push_back(bind_data.schema.column_types[field_idx]);
+			} else if (col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+				// _score virtual column
+				state->projected.field_paths.push_back("_score");
+				state->projected.es_types.push_back("");
+				state->projected.column_types.push_back(LogicalType::DOUBLE);
 			} else {
 				// _unmapped_ column
 				state->projected.field_paths.push_back("_unmapped_");
@@ -460,6 +571,11 @@ static unique_ptr<GlobalTableFunctionState> ElasticsearchQueryInitGlobal(ClientC
 				state->projected.field_paths.push_back(bind_data.schema.field_paths[field_idx]);
 				state->projected.es_types.push_back(bind_data.schema.es_types[field_idx]);
 				state->projected.column_types.push_back(bind_data.schema.column_types[field_idx]);
+			} else if (col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+				// _score virtual column
+				state->projected.field_paths.push_back("_score");
+				state->projected.es_types.push_back("");
+				state->projected.column_types.push_back(LogicalType::DOUBLE);
 			} else {
 				// _unmapped_ column
 				state->projected.field_paths.push_back("_unmapped_");
@@ -482,6 +598,9 @@ static unique_ptr<GlobalTableFunctionState> ElasticsearchQueryInitGlobal(ClientC
 	}
 
 	// Build the final query with pushdown.
+	// The filters include the join filters DuckDB derives from the build side of a hash join (the key range and,
+	// for few keys, the key set). The scan of the probe side is only initialized after the build side is complete,
+	// so they are known before the first page is requested.
 	state->final_query = BuildFinalQuery(bind_data, input.filters.get(), input.column_ids, input.projection_ids);
 
 	// Create client.
@@ -537,138 +656,6 @@ static unique_ptr<GlobalTableFunctionState> ElasticsearchQueryInitGlobal(ClientC
 	return std::move(state);
 }
 
-// Collect unmapped fields from _source that are not in the schema's mapped paths.
-// Returns a VariantValue of unmapped fields or a null VariantValue if none found.
-// Used to populate the _unmapped_ output column during scanning.
-static VariantValue CollectUnmappedFields(yyjson_val *source, const std::set<std::string> &mapped_paths,
-                                          const std::string &prefix = "") {
-	if (!source || !yyjson_is_obj(source)) {
-		return VariantValue(Value());
-	}
-
-	bool has_unmapped = false;
-	VariantValue result_obj(VariantValueType::OBJECT);
-
-	// Recursive helper to collect unmapped fields.
-	std::function<void(yyjson_val *, VariantValue &, const std::string &)> collect_unmapped =
-	    [&](yyjson_val *obj, VariantValue &target, const std::string &current_prefix) {
-		    if (!obj || !yyjson_is_obj(obj))
-			    return;
-
-		    yyjson_obj_iter iter;
-		    yyjson_obj_iter_init(obj, &iter);
-		    yyjson_val *key;
-
-		    while ((key = yyjson_obj_iter_next(&iter))) {
-			    const char *field_name = yyjson_get_str(key);
-			    yyjson_val *field_val = yyjson_obj_iter_get_val(key);
-
-			    std::string field_path = current_prefix.empty() ? field_name : current_prefix + "." + field_name;
-
-			    // Check if this exact path is mapped.
-			    bool is_mapped = mapped_paths.count(field_path) > 0;
-
-			    // Also check if any mapped path starts with this path (it's a parent of a mapped field).
-			    bool is_parent_of_mapped = false;
-			    for (const auto &mapped_path : mapped_paths) {
-				    if (mapped_path.find(field_path + ".") == 0) {
-					    is_parent_of_mapped = true;
-					    break;
-				    }
-			    }
-
-			    if (is_mapped) {
-				    // This field is mapped, but check if it is an object/nested type with child fields.
-				    // If the field has no children in mapped_paths, it's a terminal type (geo_point etc.)
-				    // and we should not recurse into it even if the value is an object.
-				    bool has_mapped_children = false;
-				    for (const auto &mp : mapped_paths) {
-					    if (mp.find(field_path + ".") == 0) {
-						    has_mapped_children = true;
-						    break;
-					    }
-				    }
-
-				    if (has_mapped_children && yyjson_is_obj(field_val)) {
-					    // This is an object/nested type with defined child fields, check for unmapped children.
-					    VariantValue sub_obj(VariantValueType::OBJECT);
-					    bool sub_has_unmapped = false;
-
-					    yyjson_obj_iter sub_iter;
-					    yyjson_obj_iter_init(field_val, &sub_iter);
-					    yyjson_val *sub_key;
-
-					    while ((sub_key = yyjson_obj_iter_next(&sub_iter))) {
-						    const char *subfield_name = yyjson_get_str(sub_key);
-						    yyjson_val *subfield_val = yyjson_obj_iter_get_val(sub_key);
-						    std::string subfield_path = field_path + "." + subfield_name;
-
-						    if (mapped_paths.count(subfield_path) == 0) {
-							    // Check if it's a parent of any mapped field.
-							    bool is_sub_parent = false;
-							    for (const auto &mp : mapped_paths) {
-								    if (mp.find(subfield_path + ".") == 0) {
-									    is_sub_parent = true;
-									    break;
-								    }
-							    }
-
-							    if (!is_sub_parent) {
-								    // This subfield is unmapped, add it.
-								    sub_obj.AddChild(subfield_name, ConvertYyjsonToVariantValue(subfield_val));
-								    sub_has_unmapped = true;
-							    } else {
-								    // Recurse into this object.
-								    VariantValue nested_obj(VariantValueType::OBJECT);
-								    collect_unmapped(subfield_val, nested_obj, subfield_path);
-								    if (!nested_obj.object_children.empty()) {
-									    sub_obj.AddChild(subfield_name, std::move(nested_obj));
-									    sub_has_unmapped = true;
-								    }
-							    }
-						    } else if (yyjson_is_obj(subfield_val)) {
-							    // Recurse for nested mapped objects.
-							    VariantValue nested_obj(VariantValueType::OBJECT);
-							    collect_unmapped(subfield_val, nested_obj, subfield_path);
-							    if (!nested_obj.object_children.empty()) {
-								    sub_obj.AddChild(subfield_name, std::move(nested_obj));
-								    sub_has_unmapped = true;
-							    }
-						    }
-					    }
-
-					    if (sub_has_unmapped) {
-						    target.AddChild(field_name, std::move(sub_obj));
-						    has_unmapped = true;
-					    }
-				    }
-				    // Terminal type (geo_point, keyword etc.), do not recurse.
-			    } else if (is_parent_of_mapped) {
-				    // This is a parent object of mapped fields, recurse to find unmapped children.
-				    if (yyjson_is_obj(field_val)) {
-					    VariantValue sub_obj(VariantValueType::OBJECT);
-					    collect_unmapped(field_val, sub_obj, field_path);
-					    if (!sub_obj.object_children.empty()) {
-						    target.AddChild(field_name, std::move(sub_obj));
-						    has_unmapped = true;
-					    }
-				    }
-			    } else {
-				    // This field is completely unmapped, add the entire value.
-				    target.AddChild(field_name, ConvertYyjsonToVariantValue(field_val));
-				    has_unmapped = true;
-			    }
-		    }
-	    };
-
-	collect_unmapped(source, result_obj, prefix);
-
-	if (has_unmapped) {
-		return result_obj;
-	}
-	return VariantValue(Value());
-}
-
 // Main scan function.
 static void ElasticsearchQueryScan(ClientContext &context, TableFunctionInput &data, DataChunk &output) {
 	auto &bind_data = data.bind_data->Cast<ElasticsearchQueryBindData>();
@@ -794,6 +781,14 @@ static void ElasticsearchQueryScan(ClientContext &context, TableFunctionInput &d
 				} else {
 					FlatVector::SetNull(output.data[out_col], output_idx, true);
 				}
+			} else if (col_id == ELASTICSEARCH_SCORE_COLUMN_ID) {
+				// _score column: null when Elasticsearch did not compute scores.
+				yyjson_val *score_val = yyjson_obj_get(hit, "_score");
+				if (score_val && yyjson_is_num(score_val)) {
+					FlatVector::GetData<double>(output.data[out_col])[output_idx] = yyjson_get_num(score_val);
+				} else {
+					FlatVector::SetNull(output.data[out_col], output_idx, true);
+				}
 			} else if (field_path == "_unmapped_") {
 				// _unmapped_ column: collect VariantValue written to output after the scan loop.
 				VariantValue unmapped = CollectUnmappedFields(source, bind_data.schema.all_mapped_paths);
@@ -1069,20 +1064,25 @@ static unique_ptr<TableFilter> WrapInStructFilters(unique_ptr<TableFilter> inner
 	return result;
 }
 
-// Try to push a simple comparison filter into table_filters.
+// Try to create a ConstantFilter for a simple comparison.
 // This replicates the core logic of FilterCombiner::AddBoundComparisonFilter + TryPushdownConstantFilter.
 // We do this in pushdown_complex_filter because pushing any filter to table_filters causes the
 // DuckDB optimizer to skip the FilterCombiner path. By also handling comparisons here, all filter types
 // are pushed in a single pass.
-static bool TryPushComparisonFilter(ClientContext &context, const BoundComparisonExpression &comp_expr,
-                                    const ElasticsearchSchema &schema, const vector<ColumnIndex> &column_ids,
-                                    LogicalGet &get) {
+static unique_ptr<TableFilter> TryCreateComparisonFilter(ClientContext &context,
+                                                         const BoundComparisonExpression &comp_expr,
+                                                         const ElasticsearchSchema &schema,
+                                                         const vector<ColumnIndex> &column_ids,
+                                                         ColumnPathInfo &col_path) {
 	auto expr_type = comp_expr.GetExpressionType();
-	// Support: =, !=, >, >=, <, <=
+	// Support: =, !=, >, >=, <, <=, IS DISTINCT FROM, IS NOT DISTINCT FROM
+	bool is_distinct = expr_type == ExpressionType::COMPARE_DISTINCT_FROM ||
+	                   expr_type == ExpressionType::COMPARE_NOT_DISTINCT_FROM;
 	if (expr_type != ExpressionType::COMPARE_EQUAL && expr_type != ExpressionType::COMPARE_NOTEQUAL &&
 	    expr_type != ExpressionType::COMPARE_GREATERTHAN && expr_type != ExpressionType::COMPARE_GREATERTHANOREQUALTO &&
-	    expr_type != ExpressionType::COMPARE_LESSTHAN && expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO) {
-		return false;
+	    expr_type != ExpressionType::COMPARE_LESSTHAN && expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO &&
+	    !is_distinct) {
+		return nullptr;
 	}
 
 	// One side must be a column reference, the other a foldable scalar.
@@ -1090,7 +1090,7 @@ static bool TryPushComparisonFilter(ClientContext &context, const BoundCompariso
 	bool right_is_scalar = comp_expr.right->IsFoldable();
 	if (left_is_scalar == right_is_scalar) {
 		// Both scalars (constant expression, not a filter) or both column refs (join condition).
-		return false;
+		return nullptr;
 	}
 
 	auto &col_expr = left_is_scalar ? *comp_expr.right : *comp_expr.left;
@@ -1098,41 +1098,45 @@ static bool TryPushComparisonFilter(ClientContext &context, const BoundCompariso
 
 	ColumnPathInfo col_path_info = ExtractColumnPath(col_expr, schema, column_ids);
 	if (!col_path_info.IsValid()) {
-		return false;
+		return nullptr;
 	}
 
 	// Evaluate the scalar side to a constant value.
 	Value constant_value;
 	if (!ExpressionExecutor::TryEvaluateScalar(context, scalar_expr, constant_value)) {
-		return false;
+		return nullptr;
 	}
 	if (constant_value.IsNull()) {
-		return false;
+		return nullptr;
 	}
 
-	// If the scalar is on the left side, flip the comparison direction.
-	auto comparison_type = left_is_scalar ? FlipComparisonExpression(expr_type) : expr_type;
+	col_path = std::move(col_path_info);
 
-	unique_ptr<TableFilter> filter = make_uniq<ConstantFilter>(comparison_type, std::move(constant_value));
-	if (!col_path_info.nested_fields.empty()) {
-		filter = WrapInStructFilters(std::move(filter), col_path_info.nested_fields);
+	// IS [NOT] DISTINCT FROM has no ConstantFilter equivalent, it is pushed as an ExpressionFilter normalized
+	// to the column on the left and the constant on the right (the comparison is symmetric).
+	if (is_distinct) {
+		return make_uniq<ExpressionFilter>(make_uniq<BoundComparisonExpression>(
+		    expr_type, col_expr.Copy(), make_uniq<BoundConstantExpression>(std::move(constant_value))));
 	}
 
-	get.table_filters.PushFilter(ProjectionIndex(col_path_info.output_col_idx), std::move(filter));
-	return true;
+	// If the scalar is on the left side, flip the comparison direction.
+	auto comparison_type = left_is_scalar ? FlipComparisonExpression(expr_type) : expr_type;
+	return make_uniq<ConstantFilter>(comparison_type, std::move(constant_value));
 }
 
-// Try to push a geo_distance filter from a comparison involving ST_Distance.
+// Try to create a geo_distance filter from a comparison involving ST_Distance.
 // Recognizes patterns like ST_Distance(geo_col, ST_Point(...)) < 1000.
 // The comparison must have ST_Distance on one side and a numeric constant on the other.
 // Only <, <=, >, >= are supported (not = or !=).
-static bool TryPushGeoDistanceFilter(ClientContext &context, const BoundComparisonExpression &comp_expr,
-                                     const ElasticsearchSchema &schema, const vector<ColumnIndex> &column_ids,
-                                     LogicalGet &get) {
+static unique_ptr<TableFilter> TryCreateGeoDistanceFilter(ClientContext &context,
+                                                          const BoundComparisonExpression &comp_expr,
+                                                          const ElasticsearchSchema &schema,
+                                                          const vector<ColumnIndex> &column_ids,
+                                                          ColumnPathInfo &col_path) {
 	auto expr_type = comp_expr.GetExpressionType();
 	if (expr_type != ExpressionType::COMPARE_LESSTHAN && expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO &&
 	    expr_type != ExpressionType::COMPARE_GREATERTHAN && expr_type != ExpressionType::COMPARE_GREATERTHANOREQUALTO) {
-		return false;
+		return nullptr;
 	}
 
 	// Identify which side is the ST_Distance function and which is the distance constant.
@@ -1157,27 +1161,27 @@ static bool TryPushGeoDistanceFilter(ClientContext &context, const BoundComparis
 		}
 	}
 	if (!dist_func_expr) {
-		return false;
+		return nullptr;
 	}
 
 	// Extract the distance constant.
 	if (!dist_value_expr->IsFoldable()) {
-		return false;
+		return nullptr;
 	}
 	Value distance_val;
 	if (!ExpressionExecutor::TryEvaluateScalar(context, *dist_value_expr, distance_val)) {
-		return false;
+		return nullptr;
 	}
 	if (distance_val.IsNull()) {
-		return false;
+		return nullptr;
 	}
 	double distance_meters;
 	if (!distance_val.DefaultTryCastAs(LogicalType::DOUBLE)) {
-		return false;
+		return nullptr;
 	}
 	distance_meters = DoubleValue::Get(distance_val);
 	if (distance_meters < 0) {
-		return false;
+		return nullptr;
 	}
 
 	// From ST_Distance's children, extract the geo column and the constant point.
@@ -1188,14 +1192,14 @@ static bool TryPushGeoDistanceFilter(ClientContext &context, const BoundComparis
 		geo_col = ExtractGeoColumnFromArg(*func_expr.children[1], schema, column_ids, 1);
 	}
 	if (!geo_col.IsValid()) {
-		return false;
+		return nullptr;
 	}
 
 	// Extract the constant geometry (must be a point for geo_distance).
 	idx_t const_arg_idx = (geo_col.arg_index == 0) ? 1 : 0;
 	ConstantGeoInfo const_geo = ExtractConstantGeo(*func_expr.children[const_arg_idx]);
 	if (!const_geo.IsValid() || const_geo.is_envelope) {
-		return false;
+		return nullptr;
 	}
 
 	// Build a modified comparison expression for the ExpressionFilter.
@@ -1209,384 +1213,1685 @@ static bool TryPushGeoDistanceFilter(ClientContext &context, const BoundComparis
 	auto &mod_func = mod_func_ref->Cast<BoundFunctionExpression>();
 	mod_func.children[const_arg_idx] = make_uniq<BoundConstantExpression>(Value(const_geo.geojson));
 
-	unique_ptr<TableFilter> expr_filter = make_uniq<ExpressionFilter>(std::move(modified_expr));
-	if (!geo_col.col_path.nested_fields.empty()) {
-		expr_filter = WrapInStructFilters(std::move(expr_filter), geo_col.col_path.nested_fields);
+	col_path = std::move(geo_col.col_path);
+	return make_uniq<ExpressionFilter>(std::move(modified_expr));
+}
+
+// Truncate a timestamp to the start of a date_trunc unit (year, quarter, month, week, day, hour, minute or second).
+// Returns false for other units and for infinite timestamps.
+static bool TruncateTimestamp(timestamp_t ts, const string &unit, timestamp_t &result) {
+	if (!Timestamp::IsFinite(ts)) {
+		return false;
+	}
+	date_t date;
+	dtime_t time;
+	Timestamp::Convert(ts, date, time);
+	int64_t micros = time.micros;
+	if (unit == "year" || unit == "quarter" || unit == "month") {
+		int32_t year, month, day;
+		Date::Convert(date, year, month, day);
+		if (unit == "year") {
+			month = 1;
+		} else if (unit == "quarter") {
+			month = (month - 1) / 3 * 3 + 1;
+		}
+		date = Date::FromDate(year, month, 1);
+		micros = 0;
+	} else if (unit == "week") {
+		// ISO weeks start on Monday.
+		date = date - (Date::ExtractISODayOfTheWeek(date) - 1);
+		micros = 0;
+	} else if (unit == "day") {
+		micros = 0;
+	} else if (unit == "hour") {
+		micros -= micros % Interval::MICROS_PER_HOUR;
+	} else if (unit == "minute") {
+		micros -= micros % Interval::MICROS_PER_MINUTE;
+	} else if (unit == "second") {
+		micros -= micros % Interval::MICROS_PER_SEC;
+	} else {
+		return false;
 	}
+	result = Timestamp::FromDatetime(date, dtime_t(micros));
+	return true;
+}
 
-	get.table_filters.PushFilter(ProjectionIndex(geo_col.col_path.output_col_idx), std::move(expr_filter));
+// Add one date_trunc unit to a timestamp truncated to that unit (see TruncateTimestamp).
+static bool AddTimestampUnit(timestamp_t ts, const string &unit, timestamp_t &result) {
+	date_t date;
+	dtime_t time;
+	Timestamp::Convert(ts, date, time);
+	if (unit == "year" || unit == "quarter" || unit == "month") {
+		int32_t year, month, day;
+		Date::Convert(date, year, month, day);
+		month += unit == "year" ? 12 : unit == "quarter" ? 3 : 1;
+		year += (month - 1) / 12;
+		month = (month - 1) % 12 + 1;
+		if (!Date::IsValid(year, month, 1)) {
+			return false;
+		}
+		date = Date::FromDate(year, month, 1);
+	} else if (unit == "week") {
+		date = date + 7;
+	} else if (unit == "day") {
+		date = date + 1;
+	} else {
+		int64_t unit_micros = unit == "hour"     ? Interval::MICROS_PER_HOUR
+		                      : unit == "minute" ? Interval::MICROS_PER_MINUTE
+		                                         : Interval::MICROS_PER_SEC;
+		result = Timestamp::FromEpochMicroSeconds(Timestamp::GetEpochMicroSeconds(ts) + unit_micros);
+		return true;
+	}
+	result = Timestamp::FromDatetime(date, time);
 	return true;
 }
 
-// Pushdown complex filter callback.
-// Processes all filter expressions in a single pass:
-// - Comparison filters -> ConstantFilter
-// - IS NULL / IS NOT NULL -> IsNullFilter / IsNotNullFilter
-// - IN expressions -> InFilter
-// - LIKE/ILIKE patterns, prefix/suffix/contains -> ExpressionFilter
-// - ST_Distance comparisons -> ExpressionFilter
-// - ST_DWithin, ST_Within, ST_Intersects, ST_Contains, ST_Disjoint -> ExpressionFilter
+// Try to create a filter on a date field from a comparison or BETWEEN of a date function of the field against
+// constants, such as col::DATE = '2026-10-01' or extract(hour FROM col) BETWEEN 9 AND 17.
 //
-// All recognized filters are pushed into get.table_filters and consumed from the filters vector.
-// This approach handles everything in one pass, avoiding the issue where pushing to table_filters
-// in pushdown_complex_filter causes DuckDB's optimizer to skip the FilterCombiner path,
-// which would prevent standard comparison filters from being pushed down.
+// CAST(col AS DATE), date_trunc('unit', col), year(col) and date_part('year', col) round the timestamp down to a
+// unit, so they are monotonic and every comparison is equivalent to a range of the field itself:
+// date_trunc('month', col) = '2026-10-01' is col >= '2026-10-01' AND col < '2026-11-01', date_trunc('month', col) >
+// '2026-10-15' is col >= '2026-11-01' and so on. These become ConstantFilters, which are translated into range
+// queries. An equality with a constant that is not the start of a unit never matches and is left to DuckDB.
 //
-// For text fields without a .keyword subfield, comparison/LIKE/ILIKE/IN filters are not
-// pushed - they are left for DuckDB's FILTER stage. For geo fields (geo_point, geo_shape),
-// equality/inequality and IN are deferred to DuckDB's FILTER stage, while range comparisons
-// are rejected with an error. When such filters are deferred and no other filters have been
-// pushed into table_filters, a no-op IsNotNullFilter on _id is injected as a guard.
-// This causes DuckDB's FilterCombiner (which runs after this callback) to see a non-empty
-// table_filters and skip its own pushdown, preventing it from re-pushing the deferred filters
-// as ConstantFilter/InFilter. The guard is optimized away by the optimizer extension
-// (OptimizeIdFilters in elasticsearch_optimizer.cpp) as part of the general _id semantic
-// optimization: _id IS NOT NULL is always true, so it is stripped. TranslateFilters also
-// skips _id null filters as defense-in-depth.
-static void ElasticsearchPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
-                                               vector<unique_ptr<Expression>> &filters) {
-	auto &bind_data = bind_data_p->Cast<ElasticsearchQueryBindData>();
-	const auto &column_ids = get.GetColumnIds();
-
-	// Track whether any filters were deferred to DuckDB (e.g. comparisons/IN on text fields without
-	// .keyword or geo fields). Used to decide whether a guard filter is needed - see comment block
-	// after the loop.
-	bool has_deferred_filters = false;
+// Other date parts (month, day, hour, day of week, ...) are not monotonic. They are only pushed with the
+// elasticsearch_enable_script_pushdown setting, as an ExpressionFilter normalized to the date part on the left and
+// BIGINT constants on the right, which the filter translator turns into a script query.
+static unique_ptr<TableFilter> TryCreateDateFunctionFilter(ClientContext &context, const Expression &filter,
+                                                           const ElasticsearchSchema &schema,
+                                                           const vector<ColumnIndex> &column_ids,
+                                                           ColumnPathInfo &col_path) {
+	// Collect the comparisons of the date function against constants.
+	const Expression *func_expr;
+	vector<std::pair<ExpressionType, Value>> comparisons;
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+		auto &comp_expr = filter.Cast<BoundComparisonExpression>();
+		auto expr_type = comp_expr.GetExpressionType();
+		if (expr_type != ExpressionType::COMPARE_EQUAL && expr_type != ExpressionType::COMPARE_NOTEQUAL &&
+		    expr_type != ExpressionType::COMPARE_GREATERTHAN &&
+		    expr_type != ExpressionType::COMPARE_GREATERTHANOREQUALTO &&
+		    expr_type != ExpressionType::COMPARE_LESSTHAN && expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+			return nullptr;
+		}
+		bool left_is_scalar = comp_expr.left->IsFoldable();
+		if (left_is_scalar == comp_expr.right->IsFoldable()) {
+			return nullptr;
+		}
+		func_expr = left_is_scalar ? comp_expr.right.get() : comp_expr.left.get();
+		Value constant;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, left_is_scalar ? *comp_expr.left : *comp_expr.right,
+		                                           constant) ||
+		    constant.IsNull()) {
+			return nullptr;
+		}
+		comparisons.emplace_back(left_is_scalar ? FlipComparisonExpression(expr_type) : expr_type,
+		                         std::move(constant));
+	} else if (filter.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+		auto &between_expr = filter.Cast<BoundBetweenExpression>();
+		if (between_expr.input->IsFoldable() || !between_expr.lower->IsFoldable() ||
+		    !between_expr.upper->IsFoldable()) {
+			return nullptr;
+		}
+		func_expr = between_expr.input.get();
+		Value lower, upper;
+		if (!ExpressionExecutor::TryEvaluateScalar(context, *between_expr.lower, lower) ||
+		    !ExpressionExecutor::TryEvaluateScalar(context, *between_expr.upper, upper) || lower.IsNull() ||
+		    upper.IsNull()) {
+			return nullptr;
+		}
+		comparisons.emplace_back(between_expr.lower_inclusive ? ExpressionType::COMPARE_GREATERTHANOREQUALTO
+		                                                      : ExpressionType::COMPARE_GREATERTHAN,
+		                         std::move(lower));
+		comparisons.emplace_back(between_expr.upper_inclusive ? ExpressionType::COMPARE_LESSTHANOREQUALTO
+		                                                      : ExpressionType::COMPARE_LESSTHAN,
+		                         std::move(upper));
+	} else {
+		return nullptr;
+	}
 
-	for (idx_t i = 0; i < filters.size(); i++) {
-		auto &filter = filters[i];
-		if (!filter) {
-			continue;
+	// Find the date column and the unit the function rounds it down to (none for non-monotonic date parts).
+	const Expression *col_expr;
+	string unit;
+	string part;
+	if (func_expr->GetExpressionClass() == ExpressionClass::BOUND_CAST) {
+		auto &cast_expr = func_expr->Cast<BoundCastExpression>();
+		if (cast_expr.return_type.id() != LogicalTypeId::DATE) {
+			return nullptr;
 		}
+		col_expr = cast_expr.child.get();
+		unit = "day";
+	} else if (ExtractDatePart(*func_expr, part)) {
+		col_expr = func_expr->Cast<BoundFunctionExpression>().children.back().get();
+		if (part == "year") {
+			unit = "year";
+		}
+	} else if (func_expr->GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+		auto &trunc_expr = func_expr->Cast<BoundFunctionExpression>();
+		if ((trunc_expr.function.name != "date_trunc" && trunc_expr.function.name != "datetrunc") ||
+		    trunc_expr.children.size() != 2 || !ExtractConstantString(*trunc_expr.children[0], unit)) {
+			return nullptr;
+		}
+		// date_trunc accepts plurals ('days') as well.
+		unit = StringUtil::Lower(unit);
+		if (unit.size() > 1 && unit.back() == 's') {
+			unit.pop_back();
+		}
+		col_expr = trunc_expr.children[1].get();
+	} else {
+		return nullptr;
+	}
 
-		// Handle comparison expressions.
-		if (filter->GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
-			auto &comp_expr = filter->Cast<BoundComparisonExpression>();
+	if (col_expr->return_type.id() != LogicalTypeId::TIMESTAMP) {
+		return nullptr;
+	}
+	ColumnPathInfo col_path_info = ExtractColumnPath(*col_expr, schema, column_ids);
+	if (!col_path_info.IsValid()) {
+		return nullptr;
+	}
+	auto es_type = schema.es_type_map.find(col_path_info.full_path);
+	if (es_type == schema.es_type_map.end() || es_type->second != "date") {
+		return nullptr;
+	}
 
-			// Skip comparisons on text fields without .keyword (they cannot be pushed to Elasticsearch
-			// because the field is analyzed/tokenized). The guard filter mechanism (see after the loop)
-			// prevents the FilterCombiner from re-pushing these as ConstantFilter.
-			ColumnPathInfo col_path_info = ExtractColumnPath(*comp_expr.left, bind_data.schema, column_ids);
-			if (!col_path_info.IsValid()) {
-				col_path_info = ExtractColumnPath(*comp_expr.right, bind_data.schema, column_ids);
+	// Non-monotonic date parts are evaluated by a script, which is slow and may be disabled on the cluster.
+	if (unit.empty()) {
+		Value setting_val;
+		if (!context.TryGetCurrentSetting("elasticsearch_enable_script_pushdown", setting_val) ||
+		    !BooleanValue::Get(setting_val)) {
+			return nullptr;
+		}
+		vector<unique_ptr<Expression>> constants;
+		for (auto &comparison : comparisons) {
+			Value constant = comparison.second;
+			if (!constant.type().IsIntegral() || !constant.DefaultTryCastAs(LogicalType::BIGINT)) {
+				return nullptr;
 			}
-
-			if (col_path_info.IsValid()) {
-				const string &col_name = col_path_info.full_path;
-				bool is_text_field = bind_data.schema.text_fields.count(col_name) > 0;
-				bool has_keyword_subfield = bind_data.schema.text_fields_with_keyword.count(col_name) > 0;
-
-				if (is_text_field && !has_keyword_subfield) {
-					has_deferred_filters = true;
-					continue;
-				}
-
-				// Standard comparisons on geo fields cannot be pushed to Elasticsearch:
-				// - = and != would generate invalid term queries on geo fields
-				// - <, >, <=, >= are semantically meaningless for geometry types
-				// Note: ST_Distance(...) < N patterns are not caught here because ExtractColumnPath
-				// returns invalid for function expressions like ST_Distance - they fall through to
-				// TryPushGeoDistanceFilter below.
-				bool is_geo_field = bind_data.schema.geo_fields.count(col_name) > 0;
-				if (is_geo_field) {
-					auto comp_type = comp_expr.GetExpressionType();
-					if (comp_type == ExpressionType::COMPARE_GREATERTHAN ||
-					    comp_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO ||
-					    comp_type == ExpressionType::COMPARE_LESSTHAN ||
-					    comp_type == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
-						throw InvalidInputException(
-						    "Range comparisons (<, >, <=, >=) are not supported on geo field '%s'.", col_name);
-					}
-					// = and != are deferred to DuckDB's FILTER stage.
-					has_deferred_filters = true;
-					continue;
-				}
+			constants.push_back(make_uniq<BoundConstantExpression>(std::move(constant)));
+		}
+		unique_ptr<Expression> script_expr;
+		if (filter.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+			auto &between_expr = filter.Cast<BoundBetweenExpression>();
+			script_expr = make_uniq<BoundBetweenExpression>(func_expr->Copy(), std::move(constants[0]),
+			                                                std::move(constants[1]), between_expr.lower_inclusive,
+			                                                between_expr.upper_inclusive);
+		} else {
+			script_expr = make_uniq<BoundComparisonExpression>(comparisons[0].first, func_expr->Copy(),
+			                                                   std::move(constants[0]));
+		}
+		col_path = std::move(col_path_info);
+		return make_uniq<ExpressionFilter>(std::move(script_expr));
+	}
+
+	// Intersect the ranges [lower, upper) of the comparisons.
+	bool has_lower = false;
+	bool has_upper = false;
+	timestamp_t lower;
+	timestamp_t upper;
+	auto restrict_lower = [&](timestamp_t value) {
+		lower = has_lower ? MaxValue(lower, value) : value;
+		has_lower = true;
+	};
+	auto restrict_upper = [&](timestamp_t value) {
+		upper = has_upper ? MinValue(upper, value) : value;
+		has_upper = true;
+	};
+	for (auto &comparison : comparisons) {
+		// The start of the unit the constant falls into and of the next unit.
+		timestamp_t start;
+		timestamp_t next;
+		bool aligned;
+		Value constant = comparison.second;
+		if (!part.empty()) {
+			// year(col) is compared to a year number.
+			if (!constant.type().IsIntegral() || !constant.DefaultTryCastAs(LogicalType::INTEGER)) {
+				return nullptr;
 			}
-
-			// Try geo_distance pushdown first: ST_Distance(...) < N or N > ST_Distance(...).
-			if (TryPushGeoDistanceFilter(context, comp_expr, bind_data.schema, column_ids, get)) {
-				filters[i] = nullptr;
-				continue;
+			auto year = IntegerValue::Get(constant);
+			if (!Date::IsValid(year, 1, 1)) {
+				return nullptr;
 			}
-
-			// Push comparison as ConstantFilter.
-			if (TryPushComparisonFilter(context, comp_expr, bind_data.schema, column_ids, get)) {
-				filters[i] = nullptr;
+			start = Timestamp::FromDatetime(Date::FromDate(year, 1, 1), dtime_t(0));
+			aligned = true;
+		} else {
+			if (!constant.DefaultTryCastAs(LogicalType::TIMESTAMP)) {
+				return nullptr;
 			}
-			continue;
+			auto ts = TimestampValue::Get(constant);
+			if (!TruncateTimestamp(ts, unit, start)) {
+				return nullptr;
+			}
+			aligned = start == ts;
+		}
+		if (!AddTimestampUnit(start, unit, next)) {
+			return nullptr;
 		}
 
-		// Handle LIKE/ILIKE patterns, string functions and geospatial functions.
-		if (filter->GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
-			auto &func_expr = filter->Cast<BoundFunctionExpression>();
-			const auto &func_name = func_expr.function.name;
-
-			// Handle LIKE/ILIKE patterns and optimized string functions (prefix, suffix, contains).
-			// DuckDB's optimizer transforms LIKE patterns before filter pushdown:
-			// - LikeOptimizationRule: LIKE 'prefix%' -> prefix(), LIKE '%suffix' -> suffix() etc.
-			// - FilterCombiner: converts prefix() to range filters and returns PUSHED_DOWN_PARTIALLY
-			// By intercepting here, we can use Elasticsearch's native prefix/wildcard queries.
-			if (func_name == "~~" || func_name == "like_escape" || func_name == "~~*" || func_name == "ilike_escape" ||
-			    func_name == "prefix" || func_name == "suffix" || func_name == "contains") {
-				if (func_expr.children.size() < 2) {
-					continue;
-				}
+		switch (comparison.first) {
+		case ExpressionType::COMPARE_EQUAL:
+			if (!aligned) {
+				return nullptr;
+			}
+			restrict_lower(start);
+			restrict_upper(next);
+			break;
+		case ExpressionType::COMPARE_GREATERTHAN:
+			restrict_lower(next);
+			break;
+		case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+			restrict_lower(aligned ? start : next);
+			break;
+		case ExpressionType::COMPARE_LESSTHAN:
+			restrict_upper(aligned ? start : next);
+			break;
+		case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+			restrict_upper(next);
+			break;
+		default:
+			// != is a union of two ranges.
+			return nullptr;
+		}
+	}
 
-				if (func_expr.children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
-					continue;
-				}
+	col_path = std::move(col_path_info);
+	unique_ptr<TableFilter> lower_filter;
+	unique_ptr<TableFilter> upper_filter;
+	if (has_lower) {
+		lower_filter = make_uniq<ConstantFilter>(ExpressionType::COMPARE_GREATERTHANOREQUALTO, Value::TIMESTAMP(lower));
+	}
+	if (has_upper) {
+		upper_filter = make_uniq<ConstantFilter>(ExpressionType::COMPARE_LESSTHAN, Value::TIMESTAMP(upper));
+	}
+	if (!lower_filter) {
+		return upper_filter;
+	}
+	if (!upper_filter) {
+		return lower_filter;
+	}
+	auto range_filter = make_uniq<ConjunctionAndFilter>();
+	range_filter->child_filters.push_back(std::move(lower_filter));
+	range_filter->child_filters.push_back(std::move(upper_filter));
+	return std::move(range_filter);
+}
 
-				auto &pattern_expr = func_expr.children[1]->Cast<BoundConstantExpression>();
-				if (pattern_expr.value.type().id() != LogicalTypeId::VARCHAR) {
-					continue;
-				}
+// Try to create a filter on a date field from a comparison with a time relative to the current time, such as
+// col > now() - INTERVAL 15 MINUTE or col >= current_date. now() is not foldable, so TryCreateComparisonFilter
+// cannot push these. They are pushed as an ExpressionFilter normalized to the column on the left, which the filter
+// translator turns into a range query with Elasticsearch date math (see ExtractDateMath). Elasticsearch evaluates
+// now when the search starts, and rounded date math such as now/d-7d lets the shard request cache answer repeated
+// queries.
+static unique_ptr<TableFilter> TryCreateRelativeTimeFilter(ClientContext &context,
+                                                           const BoundComparisonExpression &comp_expr,
+                                                           const ElasticsearchSchema &schema,
+                                                           const vector<ColumnIndex> &column_ids,
+                                                           ColumnPathInfo &col_path) {
+	auto expr_type = comp_expr.GetExpressionType();
+	if (expr_type != ExpressionType::COMPARE_GREATERTHAN && expr_type != ExpressionType::COMPARE_GREATERTHANOREQUALTO &&
+	    expr_type != ExpressionType::COMPARE_LESSTHAN && expr_type != ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+		return nullptr;
+	}
 
-				ColumnPathInfo col_path_info = ExtractColumnPath(*func_expr.children[0], bind_data.schema, column_ids);
-				if (!col_path_info.IsValid()) {
-					continue;
-				}
+	string date_math;
+	bool rounded;
+	bool column_on_left = ExtractDateMath(*comp_expr.right, date_math, rounded);
+	if (!column_on_left && !ExtractDateMath(*comp_expr.left, date_math, rounded)) {
+		return nullptr;
+	}
+	auto &col_side = column_on_left ? *comp_expr.left : *comp_expr.right;
+	auto &time_side = column_on_left ? *comp_expr.right : *comp_expr.left;
+	auto comparison_type = column_on_left ? expr_type : FlipComparisonExpression(expr_type);
 
-				const string &col_name = col_path_info.full_path;
-				bool is_text_field = bind_data.schema.text_fields.count(col_name) > 0;
-				bool has_keyword_subfield = bind_data.schema.text_fields_with_keyword.count(col_name) > 0;
+	// Rounded date math is rounded up for gt and lte (col > now/d is after the end of the day), unlike date_trunc.
+	if (rounded &&
+	    (comparison_type == ExpressionType::COMPARE_GREATERTHAN ||
+	     comparison_type == ExpressionType::COMPARE_LESSTHANOREQUALTO)) {
+		return nullptr;
+	}
 
-				// Skip LIKE/ILIKE on text fields without .keyword (they cannot be pushed to Elasticsearch
-				// because the field is analyzed/tokenized). The guard filter mechanism (see after the loop)
-				// prevents the FilterCombiner from re-pushing these.
-				if (is_text_field && !has_keyword_subfield) {
-					has_deferred_filters = true;
-					continue;
-				}
+	// The column is cast to TIMESTAMP WITH TIME ZONE to be compared with now().
+	const Expression *col_expr = &col_side;
+	if (col_expr->GetExpressionClass() == ExpressionClass::BOUND_CAST &&
+	    col_expr->return_type.id() == LogicalTypeId::TIMESTAMP_TZ) {
+		col_expr = col_expr->Cast<BoundCastExpression>().child.get();
+	}
+	if (col_expr->return_type.id() != LogicalTypeId::TIMESTAMP) {
+		return nullptr;
+	}
+	ColumnPathInfo col_path_info = ExtractColumnPath(*col_expr, schema, column_ids);
+	if (!col_path_info.IsValid()) {
+		return nullptr;
+	}
+	auto es_type = schema.es_type_map.find(col_path_info.full_path);
+	if (es_type == schema.es_type_map.end() || es_type->second != "date") {
+		return nullptr;
+	}
 
-				unique_ptr<TableFilter> expr_filter = make_uniq<ExpressionFilter>(filter->Copy());
-				if (!col_path_info.nested_fields.empty()) {
-					expr_filter = WrapInStructFilters(std::move(expr_filter), col_path_info.nested_fields);
-				}
+	// DuckDB interprets the current time and the timestamps of the column in the session time zone (with the ICU
+	// extension), Elasticsearch in UTC.
+	Value time_zone;
+	if (context.TryGetCurrentSetting("TimeZone", time_zone) && !time_zone.IsNull()) {
+		auto time_zone_name = StringUtil::Upper(time_zone.ToString());
+		if (time_zone_name != "UTC" && time_zone_name != "ETC/UTC" && time_zone_name != "GMT" &&
+		    time_zone_name != "ETC/GMT") {
+			return nullptr;
+		}
+	}
 
-				get.table_filters.PushFilter(ProjectionIndex(col_path_info.output_col_idx), std::move(expr_filter));
-				filters[i] = nullptr;
-				continue;
-			}
+	col_path = std::move(col_path_info);
+	return make_uniq<ExpressionFilter>(
+	    make_uniq<BoundComparisonExpression>(comparison_type, col_side.Copy(), time_side.Copy()));
+}
 
-			// Handle geospatial functions from the spatial extension.
-			string func_name_lower = StringUtil::Lower(func_name);
-			if (func_name_lower == "st_within" || func_name_lower == "st_intersects" ||
-			    func_name_lower == "st_contains" || func_name_lower == "st_disjoint") {
-				if (func_expr.children.size() < 2) {
-					continue;
-				}
+// Try to create a filter for lower(col) / upper(col) compared with constants: = and != with a constant on either
+// side, or IN with a list of constants. The column must be a keyword field or a text field with .keyword, which
+// Elasticsearch matches case-insensitively (see TranslateCaseInsensitiveTerms). Returns an ExpressionFilter with the
+// case conversion on the left, or nullptr.
+static unique_ptr<TableFilter> TryCreateCaseInsensitiveFilter(const Expression &filter,
+                                                              const ElasticsearchSchema &schema,
+                                                              const vector<ColumnIndex> &column_ids,
+                                                              ColumnPathInfo &col_path, bool &deferred) {
+	bool upper;
+	const Expression *column_expr;
+	unique_ptr<Expression> normalized_expr;
+	if (filter.GetExpressionType() == ExpressionType::COMPARE_EQUAL ||
+	    filter.GetExpressionType() == ExpressionType::COMPARE_NOTEQUAL) {
+		auto &comp_expr = filter.Cast<BoundComparisonExpression>();
+		bool function_on_left = ExtractCaseConversion(*comp_expr.left, upper);
+		if (!function_on_left && !ExtractCaseConversion(*comp_expr.right, upper)) {
+			return nullptr;
+		}
+		auto &function_expr = function_on_left ? *comp_expr.left : *comp_expr.right;
+		auto &constant_expr = function_on_left ? *comp_expr.right : *comp_expr.left;
+		if (constant_expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT ||
+		    !IsCaseConvertedValue(constant_expr.Cast<BoundConstantExpression>().value, upper)) {
+			return nullptr;
+		}
+		column_expr = function_expr.Cast<BoundFunctionExpression>().children[0].get();
+		normalized_expr = make_uniq<BoundComparisonExpression>(filter.GetExpressionType(), function_expr.Copy(),
+		                                                       constant_expr.Copy());
+	} else if (filter.GetExpressionType() == ExpressionType::COMPARE_IN) {
+		auto &op_expr = filter.Cast<BoundOperatorExpression>();
+		if (op_expr.children.size() < 2 || !ExtractCaseConversion(*op_expr.children[0], upper)) {
+			return nullptr;
+		}
+		for (idx_t i = 1; i < op_expr.children.size(); i++) {
+			if (op_expr.children[i]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT ||
+			    !IsCaseConvertedValue(op_expr.children[i]->Cast<BoundConstantExpression>().value, upper)) {
+				return nullptr;
+			}
+		}
+		column_expr = op_expr.children[0]->Cast<BoundFunctionExpression>().children[0].get();
+		normalized_expr = filter.Copy();
+	} else {
+		return nullptr;
+	}
 
-				// Try to find the geo column in either argument position.
-				GeoColumnInfo geo_col =
-				    ExtractGeoColumnFromArg(*func_expr.children[0], bind_data.schema, column_ids, 0);
-				if (!geo_col.IsValid()) {
-					geo_col = ExtractGeoColumnFromArg(*func_expr.children[1], bind_data.schema, column_ids, 1);
-				}
-				if (!geo_col.IsValid()) {
-					continue;
-				}
+	ColumnPathInfo col_path_info = ExtractColumnPath(*column_expr, schema, column_ids);
+	if (!col_path_info.IsValid() || col_path_info.full_path == "_id") {
+		return nullptr;
+	}
 
-				// The other argument must be a constant geometry expression.
-				idx_t const_arg_idx = (geo_col.arg_index == 0) ? 1 : 0;
-				ConstantGeoInfo const_geo = ExtractConstantGeo(*func_expr.children[const_arg_idx]);
-				if (!const_geo.IsValid()) {
-					continue;
-				}
+	const string &col_name = col_path_info.full_path;
+	bool is_text_field = schema.text_fields.count(col_name) > 0;
+	bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
+	if (is_text_field && !has_keyword_subfield) {
+		deferred = true;
+		return nullptr;
+	}
+	auto es_type = schema.es_type_map.find(col_name);
+	if (!is_text_field && (es_type == schema.es_type_map.end() ||
+	                       (es_type->second != "keyword" && es_type->second != "constant_keyword"))) {
+		return nullptr;
+	}
 
-				// Build a modified expression copy where the constant GEOMETRY argument
-				// is replaced with a VARCHAR GeoJSON string.
-				auto modified_expr = filter->Copy();
-				auto &mod_func = modified_expr->Cast<BoundFunctionExpression>();
-
-				if (const_geo.geojson.empty() && const_geo.is_envelope) {
-					string envelope_geojson = "{\"type\":\"envelope\",\"coordinates\":[[" + to_string(const_geo.xmin) +
-					                          "," + to_string(const_geo.ymax) + "],[" + to_string(const_geo.xmax) +
-					                          "," + to_string(const_geo.ymin) + "]]}";
-					mod_func.children[const_arg_idx] =
-					    make_uniq<BoundConstantExpression>(Value(std::move(envelope_geojson)));
-				} else if (!const_geo.geojson.empty()) {
-					mod_func.children[const_arg_idx] = make_uniq<BoundConstantExpression>(Value(const_geo.geojson));
-				}
+	col_path = std::move(col_path_info);
+	return make_uniq<ExpressionFilter>(std::move(normalized_expr));
+}
 
-				unique_ptr<TableFilter> expr_filter = make_uniq<ExpressionFilter>(std::move(modified_expr));
-				if (!geo_col.col_path.nested_fields.empty()) {
-					expr_filter = WrapInStructFilters(std::move(expr_filter), geo_col.col_path.nested_fields);
-				}
+// Check whether a function is len(list) and return it. length and array_length are aliases of len for lists.
+static const BoundFunctionExpression *GetListLengthFunction(const Expression &expr) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return nullptr;
+	}
+	auto &func_expr = expr.Cast<BoundFunctionExpression>();
+	const auto &func_name = func_expr.function.name;
+	if ((func_name != "len" && func_name != "length" && func_name != "array_length") ||
+	    func_expr.children.size() != 1 || func_expr.children[0]->return_type.id() != LogicalTypeId::LIST) {
+		return nullptr;
+	}
+	return &func_expr;
+}
 
-				get.table_filters.PushFilter(ProjectionIndex(geo_col.col_path.output_col_idx), std::move(expr_filter));
-				filters[i] = nullptr;
-				continue;
+// Check whether a comparison tests a list for values: len(list) > 0, len(list) >= 1 or len(list) != 0, with the
+// constant on either side. Returns the len function, or nullptr.
+static const BoundFunctionExpression *GetNonEmptyListLength(const BoundComparisonExpression &comp_expr) {
+	auto comp_type = comp_expr.GetExpressionType();
+	const BoundFunctionExpression *len_expr = GetListLengthFunction(*comp_expr.left);
+	const Expression *constant_expr = comp_expr.right.get();
+	if (!len_expr) {
+		len_expr = GetListLengthFunction(*comp_expr.right);
+		constant_expr = comp_expr.left.get();
+		comp_type = FlipComparisonExpression(comp_type);
+	}
+	if (!len_expr || constant_expr->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+		return nullptr;
+	}
+
+	auto &value = constant_expr->Cast<BoundConstantExpression>().value;
+	if (value.IsNull() || !value.type().IsIntegral()) {
+		return nullptr;
+	}
+	auto constant = value.GetValue<int64_t>();
+	if ((comp_type == ExpressionType::COMPARE_GREATERTHAN && constant == 0) ||
+	    (comp_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO && constant == 1) ||
+	    (comp_type == ExpressionType::COMPARE_NOTEQUAL && constant == 0)) {
+		return len_expr;
+	}
+	return nullptr;
+}
+
+// Check whether a function is a list predicate that can be pushed as a term query on an array field:
+// list_contains (list_has, array_contains, array_has), list_has_any (array_has_any, &&) and list_has_all
+// (array_has_all, @>).
+static bool IsListPredicate(const string &func_name) {
+	return func_name == "list_contains" || func_name == "list_has" || func_name == "array_contains" ||
+	       func_name == "array_has" || func_name == "list_has_any" || func_name == "array_has_any" ||
+	       func_name == "&&" || func_name == "list_has_all" || func_name == "array_has_all" || func_name == "@>";
+}
+
+// Check whether an expression is a list predicate or a test of a list for values. These are true for empty lists,
+// which Elasticsearch does not tell apart from missing fields, so their negations cannot be pushed.
+static bool IsListValuePredicate(const Expression &expr) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+		return GetNonEmptyListLength(expr.Cast<BoundComparisonExpression>()) != nullptr;
+	}
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+		return IsListPredicate(expr.Cast<BoundFunctionExpression>().function.name);
+	}
+	return false;
+}
+
+// Try to create a table filter for a single filter expression on one column. On success col_path is set to the
+// filtered column and the returned filter is not yet wrapped in StructFilters for nested object fields.
+// Handles:
+// - Comparison filters -> ConstantFilter
+// - IS NULL / IS NOT NULL -> IsNullFilter / IsNotNullFilter
+// - IN expressions -> InFilter
+// - LIKE/ILIKE and NOT LIKE/NOT ILIKE patterns, prefix/suffix/contains -> ExpressionFilter
+// - IS DISTINCT FROM / IS NOT DISTINCT FROM -> ExpressionFilter
+// - regexp_matches, regexp_full_match (~) -> ExpressionFilter
+// - ST_Distance comparisons -> ExpressionFilter
+// - ST_DWithin, ST_Within, ST_Intersects, ST_Contains, ST_Disjoint -> ExpressionFilter
+// - Comparisons and BETWEEN on date functions of date fields -> range ConstantFilters, or an ExpressionFilter for
+//   non-monotonic date parts (see TryCreateDateFunctionFilter)
+// - Comparisons of date fields with a time relative to now() -> ExpressionFilter
+// - list_contains, list_has_any and list_has_all on array fields and len(col) > 0 -> ExpressionFilter
+// - =, != and IN on lower(col) / upper(col) of keyword fields -> ExpressionFilter
+// NOT IN and other negations of these arrive as NOT expressions and are handled by TryCreateBooleanFilter.
+//
+// Sets deferred for filters that must be evaluated by DuckDB and never reach the FilterCombiner (comparisons,
+// LIKE and IN on text fields without .keyword and on geo fields).
+static unique_ptr<TableFilter> TryCreateTableFilter(ClientContext &context, const Expression &filter,
+                                                    const ElasticsearchSchema &schema,
+                                                    const vector<ColumnIndex> &column_ids, ColumnPathInfo &col_path,
+                                                    bool &deferred) {
+	// Handle comparison expressions.
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_COMPARISON) {
+		auto &comp_expr = filter.Cast<BoundComparisonExpression>();
+
+		// Handle len(col) > 0 and its equivalents, normalized to len(col) > 0: the field has a value.
+		auto len_expr = GetNonEmptyListLength(comp_expr);
+		if (len_expr) {
+			ColumnPathInfo col_path_info = ExtractColumnPath(*len_expr->children[0], schema, column_ids);
+			if (!col_path_info.IsValid() || col_path_info.full_path == "_id") {
+				return nullptr;
 			}
 
-			// Handle ST_DWithin(geom1, geom2, distance) -> geo_distance query.
-			// ST_DWithin is a 3-args function: two geometry arguments and a numeric distance.
-			// However, the spatial extension's Bind function constant-folds the distance argument.
-			// When the distance is a foldable constant (which is the common case), it erases
-			// children[2] and stores the distance in bind_info. So the expression may arrive
-			// with either 2 or 3 children.
-			if (func_name_lower == "st_dwithin") {
-				// Try to find the geo column in arg 0 or arg 1.
-				GeoColumnInfo geo_col =
-				    ExtractGeoColumnFromArg(*func_expr.children[0], bind_data.schema, column_ids, 0);
-				if (!geo_col.IsValid()) {
-					geo_col = ExtractGeoColumnFromArg(*func_expr.children[1], bind_data.schema, column_ids, 1);
-				}
-				if (!geo_col.IsValid()) {
-					continue;
-				}
+			col_path = std::move(col_path_info);
+			return make_uniq<ExpressionFilter>(make_uniq<BoundComparisonExpression>(
+			    ExpressionType::COMPARE_GREATERTHAN, len_expr->Copy(),
+			    make_uniq<BoundConstantExpression>(Value::BIGINT(0))));
+		}
+
+		// Handle case-insensitive comparisons, lower(col) = 'x' or upper(col) != 'X'.
+		auto case_insensitive_filter = TryCreateCaseInsensitiveFilter(filter, schema, column_ids, col_path, deferred);
+		if (case_insensitive_filter || deferred) {
+			return case_insensitive_filter;
+		}
 
-				// The other geometry argument must be a constant (the reference point).
-				idx_t const_arg_idx = (geo_col.arg_index == 0) ? 1 : 0;
-				ConstantGeoInfo const_geo = ExtractConstantGeo(*func_expr.children[const_arg_idx]);
-				if (!const_geo.IsValid() || const_geo.is_envelope) {
-					continue;
+		// Skip comparisons on text fields without .keyword (they cannot be pushed to Elasticsearch
+		// because the field is analyzed/tokenized). The guard filter mechanism (see
+		// ElasticsearchPushdownComplexFilter) prevents the FilterCombiner from re-pushing these as ConstantFilter.
+		ColumnPathInfo col_path_info = ExtractColumnPath(*comp_expr.left, schema, column_ids);
+		if (!col_path_info.IsValid()) {
+			col_path_info = ExtractColumnPath(*comp_expr.right, schema, column_ids);
+		}
+
+		if (col_path_info.IsValid()) {
+			const string &col_name = col_path_info.full_path;
+			bool is_text_field = schema.text_fields.count(col_name) > 0;
+			bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
+
+			if (is_text_field && !has_keyword_subfield) {
+				deferred = true;
+				return nullptr;
+			}
+
+			// Standard comparisons on geo fields cannot be pushed to Elasticsearch:
+			// - = and != would generate invalid term queries on geo fields
+			// - <, >, <=, >= are semantically meaningless for geometry types
+			// Note: ST_Distance(...) < N patterns are not caught here because ExtractColumnPath
+			// returns invalid for function expressions like ST_Distance - they fall through to
+			// TryCreateGeoDistanceFilter below.
+			bool is_geo_field = schema.geo_fields.count(col_name) > 0;
+			if (is_geo_field) {
+				auto comp_type = comp_expr.GetExpressionType();
+				if (comp_type == ExpressionType::COMPARE_GREATERTHAN ||
+				    comp_type == ExpressionType::COMPARE_GREATERTHANOREQUALTO ||
+				    comp_type == ExpressionType::COMPARE_LESSTHAN ||
+				    comp_type == ExpressionType::COMPARE_LESSTHANOREQUALTO) {
+					throw InvalidInputException(
+					    "Range comparisons (<, >, <=, >=) are not supported on geo field '%s'.", col_name);
 				}
+				// = and != are deferred to DuckDB's FILTER stage.
+				deferred = true;
+				return nullptr;
+			}
+		}
 
-				// Extract the distance. Two cases:
-				// - 3 children: distance is in children[2] (spatial extension didn't constant-fold it)
-				// - 2 children: distance was erased by the spatial extension's Bind and stored in bind_info
-				double distance_meters = 0;
-				bool distance_found = false;
+		// Try geo_distance pushdown first: ST_Distance(...) < N or N > ST_Distance(...).
+		auto geo_distance_filter = TryCreateGeoDistanceFilter(context, comp_expr, schema, column_ids, col_path);
+		if (geo_distance_filter) {
+			return geo_distance_filter;
+		}
 
-				if (func_expr.children.size() == 3) {
-					// Case 1: distance is still in the expression as children[2].
-					if (!func_expr.children[2]->IsFoldable()) {
-						continue;
-					}
-					Value dist_val;
-					if (!ExpressionExecutor::TryEvaluateScalar(context, *func_expr.children[2], dist_val)) {
-						continue;
-					}
-					if (dist_val.IsNull() || !dist_val.DefaultTryCastAs(LogicalType::DOUBLE)) {
-						continue;
+		// Try date functions of date fields: col::DATE, date_trunc, year, hour and other date parts.
+		auto date_function_filter = TryCreateDateFunctionFilter(context, filter, schema, column_ids, col_path);
+		if (date_function_filter) {
+			return date_function_filter;
+		}
+
+		// Try comparisons of date fields with a time relative to now().
+		auto relative_time_filter = TryCreateRelativeTimeFilter(context, comp_expr, schema, column_ids, col_path);
+		if (relative_time_filter) {
+			return relative_time_filter;
+		}
+
+		// Push comparison as ConstantFilter.
+		return TryCreateComparisonFilter(context, comp_expr, schema, column_ids, col_path);
+	}
+
+	// Handle BETWEEN on date functions of date fields, e.g. extract(hour FROM col) BETWEEN 9 AND 17.
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_BETWEEN) {
+		return TryCreateDateFunctionFilter(context, filter, schema, column_ids, col_path);
+	}
+
+	// Handle LIKE/ILIKE patterns, string functions and geospatial functions.
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_FUNCTION) {
+		auto &func_expr = filter.Cast<BoundFunctionExpression>();
+		const auto &func_name = func_expr.function.name;
+
+		// Handle the full-text predicates es_match, es_match_phrase and es_query_string. They run the analyzer of
+		// the field, so unlike comparisons they are pushed on text fields without a .keyword subfield as well.
+		if (func_name == "es_match" || func_name == "es_match_phrase" || func_name == "es_query_string") {
+			if (func_expr.children.size() != 2 ||
+			    func_expr.children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT ||
+			    func_expr.children[1]->Cast<BoundConstantExpression>().value.IsNull()) {
+				return nullptr;
+			}
+
+			ColumnPathInfo col_path_info = ExtractColumnPath(*func_expr.children[0], schema, column_ids);
+			if (!col_path_info.IsValid() || col_path_info.full_path == "_id") {
+				return nullptr;
+			}
+
+			col_path = std::move(col_path_info);
+			return make_uniq<ExpressionFilter>(filter.Copy());
+		}
+
+		// Handle list predicates on array fields. Elasticsearch indexes every value of an array field, so they map
+		// to term queries (see TranslateExpressionFilter). The list must be a column of scalar values, the values
+		// must be non-NULL constants.
+		if (IsListPredicate(func_name)) {
+			if (func_expr.children.size() != 2) {
+				return nullptr;
+			}
+
+			// list_has_any is symmetric, normalize it to the column on the left.
+			idx_t col_arg_idx = 0;
+			bool is_contains = func_name == "list_contains" || func_name == "list_has" ||
+			                   func_name == "array_contains" || func_name == "array_has";
+			bool is_has_any = func_name == "list_has_any" || func_name == "array_has_any" || func_name == "&&";
+			if (is_has_any && func_expr.children[0]->GetExpressionClass() == ExpressionClass::BOUND_CONSTANT) {
+				col_arg_idx = 1;
+			}
+			auto &col_expr = *func_expr.children[col_arg_idx];
+			auto &value_expr = *func_expr.children[1 - col_arg_idx];
+			if (col_expr.return_type.id() != LogicalTypeId::LIST ||
+			    ListType::GetChildType(col_expr.return_type).id() == LogicalTypeId::STRUCT ||
+			    value_expr.GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+				return nullptr;
+			}
+			auto &value = value_expr.Cast<BoundConstantExpression>().value;
+			if (value.IsNull()) {
+				return nullptr;
+			}
+			if (!is_contains) {
+				if (value.type().id() != LogicalTypeId::LIST || ListValue::GetChildren(value).empty()) {
+					return nullptr;
+				}
+				for (auto &list_value : ListValue::GetChildren(value)) {
+					if (list_value.IsNull()) {
+						return nullptr;
 					}
-					distance_meters = DoubleValue::Get(dist_val);
-					distance_found = true;
-				} else if (func_expr.bind_info) {
-					// Case 2: the spatial extension erased the distance argument at bind time.
-					// The distance is stored in bind_info with a layout compatible with
-					// SpatialDWithinBindData (double distance as the first data member).
-					auto *dwithin_bind = reinterpret_cast<const SpatialDWithinBindData *>(func_expr.bind_info.get());
-					distance_meters = dwithin_bind->distance;
-					distance_found = true;
 				}
+			}
 
-				if (!distance_found || distance_meters < 0) {
-					continue;
-				}
+			ColumnPathInfo col_path_info = ExtractColumnPath(col_expr, schema, column_ids);
+			if (!col_path_info.IsValid() || col_path_info.full_path == "_id") {
+				return nullptr;
+			}
+
+			// Term queries on text fields without .keyword would match single tokens, not the values.
+			const string &col_name = col_path_info.full_path;
+			bool is_text_field = schema.text_fields.count(col_name) > 0;
+			bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
+			if (is_text_field && !has_keyword_subfield) {
+				deferred = true;
+				return nullptr;
+			}
+			if (schema.geo_fields.count(col_name) > 0) {
+				return nullptr;
+			}
+
+			auto normalized_expr = filter.Copy();
+			if (col_arg_idx != 0) {
+				auto &normalized_func = normalized_expr->Cast<BoundFunctionExpression>();
+				std::swap(normalized_func.children[0], normalized_func.children[1]);
+			}
+			col_path = std::move(col_path_info);
+			return make_uniq<ExpressionFilter>(std::move(normalized_expr));
+		}
+
+		// Handle LIKE/ILIKE and NOT LIKE/NOT ILIKE patterns and optimized string functions (prefix, suffix, contains).
+		// DuckDB's optimizer transforms LIKE patterns before filter pushdown:
+		// - LikeOptimizationRule: LIKE 'prefix%' -> prefix(), LIKE '%suffix' -> suffix() etc.
+		// - FilterCombiner: converts prefix() to range filters and returns PUSHED_DOWN_PARTIALLY
+		// By intercepting here, we can use Elasticsearch's native prefix/wildcard queries.
+		if (func_name == "~~" || func_name == "like_escape" || func_name == "~~*" || func_name == "ilike_escape" ||
+		    func_name == "!~~" || func_name == "not_like_escape" || func_name == "!~~*" ||
+		    func_name == "not_ilike_escape" || func_name == "prefix" || func_name == "suffix" ||
+		    func_name == "contains") {
+			if (func_expr.children.size() < 2) {
+				return nullptr;
+			}
 
-				// Build a modified expression with the GEOMETRY constant replaced by a GeoJSON string.
-				// If the distance was erased from children, re-add it so that the filter translator
-				// (TranslateGeoDistanceDWithin) always sees 3 children.
-				auto modified_expr = filter->Copy();
-				auto &mod_func = modified_expr->Cast<BoundFunctionExpression>();
+			if (func_expr.children[1]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+				return nullptr;
+			}
+
+			auto &pattern_expr = func_expr.children[1]->Cast<BoundConstantExpression>();
+			if (pattern_expr.value.type().id() != LogicalTypeId::VARCHAR) {
+				return nullptr;
+			}
+
+			ColumnPathInfo col_path_info = ExtractColumnPath(*func_expr.children[0], schema, column_ids);
+			if (!col_path_info.IsValid()) {
+				return nullptr;
+			}
+
+			const string &col_name = col_path_info.full_path;
+			bool is_text_field = schema.text_fields.count(col_name) > 0;
+			bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
+
+			// Skip LIKE/ILIKE on text fields without .keyword (they cannot be pushed to Elasticsearch
+			// because the field is analyzed/tokenized). The guard filter mechanism (see
+			// ElasticsearchPushdownComplexFilter) prevents the FilterCombiner from re-pushing these.
+			if (is_text_field && !has_keyword_subfield) {
+				deferred = true;
+				return nullptr;
+			}
+
+			col_path = std::move(col_path_info);
+			return make_uniq<ExpressionFilter>(filter.Copy());
+		}
+
+		// Handle regexp_matches and regexp_full_match (the ~ operator) with patterns that have a Lucene
+		// equivalent. Others are left for DuckDB's FILTER stage.
+		if (func_name == "regexp_matches" || func_name == "regexp_full_match") {
+			string pattern;
+			string lucene_pattern;
+			bool case_insensitive;
+			if (!ExtractRegexpArguments(func_expr, pattern, case_insensitive) ||
+			    !TranslateRegexToLucene(pattern, func_name == "regexp_matches", lucene_pattern, case_insensitive)) {
+				return nullptr;
+			}
+
+			ColumnPathInfo col_path_info = ExtractColumnPath(*func_expr.children[0], schema, column_ids);
+			if (!col_path_info.IsValid()) {
+				return nullptr;
+			}
+
+			// regexp queries need the raw value: keyword fields or the .keyword subfield of text fields.
+			const string &col_name = col_path_info.full_path;
+			bool is_text_field = schema.text_fields.count(col_name) > 0;
+			bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
+			if (is_text_field && !has_keyword_subfield) {
+				deferred = true;
+				return nullptr;
+			}
+			auto es_type = schema.es_type_map.find(col_name);
+			if (!is_text_field && (es_type == schema.es_type_map.end() ||
+			                       (es_type->second != "keyword" && es_type->second != "constant_keyword" &&
+			                        es_type->second != "wildcard"))) {
+				return nullptr;
+			}
+
+			col_path = std::move(col_path_info);
+			return make_uniq<ExpressionFilter>(filter.Copy());
+		}
+
+		// Handle geospatial functions from the spatial extension.
+		string func_name_lower = StringUtil::Lower(func_name);
+		if (func_name_lower == "st_within" || func_name_lower == "st_intersects" ||
+		    func_name_lower == "st_contains" || func_name_lower == "st_disjoint") {
+			if (func_expr.children.size() < 2) {
+				return nullptr;
+			}
+
+			// Try to find the geo column in either argument position.
+			GeoColumnInfo geo_col =
+			    ExtractGeoColumnFromArg(*func_expr.children[0], schema, column_ids, 0);
+			if (!geo_col.IsValid()) {
+				geo_col = ExtractGeoColumnFromArg(*func_expr.children[1], schema, column_ids, 1);
+			}
+			if (!geo_col.IsValid()) {
+				return nullptr;
+			}
+
+			// The other argument must be a constant geometry expression.
+			idx_t const_arg_idx = (geo_col.arg_index == 0) ? 1 : 0;
+			ConstantGeoInfo const_geo = ExtractConstantGeo(*func_expr.children[const_arg_idx]);
+			if (!const_geo.IsValid()) {
+				return nullptr;
+			}
+
+			// Build a modified expression copy where the constant GEOMETRY argument
+			// is replaced with a VARCHAR GeoJSON string.
+			auto modified_expr = filter.Copy();
+			auto &mod_func = modified_expr->Cast<BoundFunctionExpression>();
+
+			if (const_geo.geojson.empty() && const_geo.is_envelope) {
+				string envelope_geojson = "{\"type\":\"envelope\",\"coordinates\":[[" + to_string(const_geo.xmin) +
+				                          "," + to_string(const_geo.ymax) + "],[" + to_string(const_geo.xmax) +
+				                          "," + to_string(const_geo.ymin) + "]]}";
+				mod_func.children[const_arg_idx] =
+				    make_uniq<BoundConstantExpression>(Value(std::move(envelope_geojson)));
+			} else if (!const_geo.geojson.empty()) {
 				mod_func.children[const_arg_idx] = make_uniq<BoundConstantExpression>(Value(const_geo.geojson));
-				if (mod_func.children.size() < 3) {
-					mod_func.children.push_back(make_uniq<BoundConstantExpression>(Value::DOUBLE(distance_meters)));
-				}
+			}
+
+			col_path = std::move(geo_col.col_path);
+			return make_uniq<ExpressionFilter>(std::move(modified_expr));
+		}
+
+		// Handle ST_DWithin(geom1, geom2, distance) -> geo_distance query.
+		// ST_DWithin is a 3-args function: two geometry arguments and a numeric distance.
+		// However, the spatial extension's Bind function constant-folds the distance argument.
+		// When the distance is a foldable constant (which is the common case), it erases
+		// children[2] and stores the distance in bind_info. So the expression may arrive
+		// with either 2 or 3 children.
+		if (func_name_lower == "st_dwithin") {
+			// Try to find the geo column in arg 0 or arg 1.
+			GeoColumnInfo geo_col =
+			    ExtractGeoColumnFromArg(*func_expr.children[0], schema, column_ids, 0);
+			if (!geo_col.IsValid()) {
+				geo_col = ExtractGeoColumnFromArg(*func_expr.children[1], schema, column_ids, 1);
+			}
+			if (!geo_col.IsValid()) {
+				return nullptr;
+			}
+
+			// The other geometry argument must be a constant (the reference point).
+			idx_t const_arg_idx = (geo_col.arg_index == 0) ? 1 : 0;
+			ConstantGeoInfo const_geo = ExtractConstantGeo(*func_expr.children[const_arg_idx]);
+			if (!const_geo.IsValid() || const_geo.is_envelope) {
+				return nullptr;
+			}
+
+			// Extract the distance. Two cases:
+			// - 3 children: distance is in children[2] (spatial extension didn't constant-fold it)
+			// - 2 children: distance was erased by the spatial extension's Bind and stored in bind_info
+			double distance_meters = 0;
+			bool distance_found = false;
 
-				unique_ptr<TableFilter> expr_filter = make_uniq<ExpressionFilter>(std::move(modified_expr));
-				if (!geo_col.col_path.nested_fields.empty()) {
-					expr_filter = WrapInStructFilters(std::move(expr_filter), geo_col.col_path.nested_fields);
+			if (func_expr.children.size() == 3) {
+				// Case 1: distance is still in the expression as children[2].
+				if (!func_expr.children[2]->IsFoldable()) {
+					return nullptr;
+				}
+				Value dist_val;
+				if (!ExpressionExecutor::TryEvaluateScalar(context, *func_expr.children[2], dist_val)) {
+					return nullptr;
 				}
+				if (dist_val.IsNull() || !dist_val.DefaultTryCastAs(LogicalType::DOUBLE)) {
+					return nullptr;
+				}
+				distance_meters = DoubleValue::Get(dist_val);
+				distance_found = true;
+			} else if (func_expr.bind_info) {
+				// Case 2: the spatial extension erased the distance argument at bind time.
+				// The distance is stored in bind_info with a layout compatible with
+				// SpatialDWithinBindData (double distance as the first data member).
+				auto *dwithin_bind = reinterpret_cast<const SpatialDWithinBindData *>(func_expr.bind_info.get());
+				distance_meters = dwithin_bind->distance;
+				distance_found = true;
+			}
 
-				get.table_filters.PushFilter(ProjectionIndex(geo_col.col_path.output_col_idx), std::move(expr_filter));
-				filters[i] = nullptr;
-				continue;
+			if (!distance_found || distance_meters < 0) {
+				return nullptr;
+			}
+
+			// Build a modified expression with the GEOMETRY constant replaced by a GeoJSON string.
+			// If the distance was erased from children, re-add it so that the filter translator
+			// (TranslateGeoDistanceDWithin) always sees 3 children.
+			auto modified_expr = filter.Copy();
+			auto &mod_func = modified_expr->Cast<BoundFunctionExpression>();
+			mod_func.children[const_arg_idx] = make_uniq<BoundConstantExpression>(Value(const_geo.geojson));
+			if (mod_func.children.size() < 3) {
+				mod_func.children.push_back(make_uniq<BoundConstantExpression>(Value::DOUBLE(distance_meters)));
 			}
+
+			col_path = std::move(geo_col.col_path);
+			return make_uniq<ExpressionFilter>(std::move(modified_expr));
 		}
+	}
 
-		// Handle IS NULL, IS NOT NULL and IN expressions.
-		if (filter->GetExpressionClass() == ExpressionClass::BOUND_OPERATOR) {
-			auto &op_expr = filter->Cast<BoundOperatorExpression>();
-			auto expr_type = op_expr.GetExpressionType();
+	// Handle IS NULL, IS NOT NULL and IN expressions.
+	if (filter.GetExpressionClass() == ExpressionClass::BOUND_OPERATOR) {
+		auto &op_expr = filter.Cast<BoundOperatorExpression>();
+		auto expr_type = op_expr.GetExpressionType();
 
-			// IS NULL / IS NOT NULL
-			if (expr_type == ExpressionType::OPERATOR_IS_NULL || expr_type == ExpressionType::OPERATOR_IS_NOT_NULL) {
-				if (op_expr.children.size() != 1) {
-					continue;
-				}
+		// IS NULL / IS NOT NULL
+		if (expr_type == ExpressionType::OPERATOR_IS_NULL || expr_type == ExpressionType::OPERATOR_IS_NOT_NULL) {
+			if (op_expr.children.size() != 1) {
+				return nullptr;
+			}
 
-				ColumnPathInfo col_path_info = ExtractColumnPath(*op_expr.children[0], bind_data.schema, column_ids);
-				if (!col_path_info.IsValid()) {
-					continue;
-				}
+			ColumnPathInfo col_path_info = ExtractColumnPath(*op_expr.children[0], schema, column_ids);
+			if (!col_path_info.IsValid()) {
+				return nullptr;
+			}
 
-				unique_ptr<TableFilter> null_filter;
-				if (expr_type == ExpressionType::OPERATOR_IS_NULL) {
-					null_filter = make_uniq<IsNullFilter>();
-				} else {
-					null_filter = make_uniq<IsNotNullFilter>();
-				}
+			col_path = std::move(col_path_info);
+			if (expr_type == ExpressionType::OPERATOR_IS_NULL) {
+				return make_uniq<IsNullFilter>();
+			}
+			return make_uniq<IsNotNullFilter>();
+		}
 
-				if (!col_path_info.nested_fields.empty()) {
-					null_filter = WrapInStructFilters(std::move(null_filter), col_path_info.nested_fields);
-				}
+		// IN expressions
+		if (expr_type == ExpressionType::COMPARE_IN) {
+			if (op_expr.children.size() < 2) {
+				return nullptr;
+			}
 
-				get.table_filters.PushFilter(ProjectionIndex(col_path_info.output_col_idx), std::move(null_filter));
-				filters[i] = nullptr;
-				continue;
+			ColumnPathInfo col_path_info = ExtractColumnPath(*op_expr.children[0], schema, column_ids);
+			if (!col_path_info.IsValid()) {
+				// Handle case-insensitive IN lists, upper(col) IN ('US', 'CA').
+				return TryCreateCaseInsensitiveFilter(filter, schema, column_ids, col_path, deferred);
 			}
 
-			// IN expressions
-			if (expr_type == ExpressionType::COMPARE_IN) {
-				if (op_expr.children.size() < 2) {
-					continue;
-				}
+			const string &col_name = col_path_info.full_path;
 
-				ColumnPathInfo col_path_info = ExtractColumnPath(*op_expr.children[0], bind_data.schema, column_ids);
-				if (!col_path_info.IsValid()) {
-					continue;
-				}
+			bool is_text_field = schema.text_fields.count(col_name) > 0;
+			bool has_keyword_subfield = schema.text_fields_with_keyword.count(col_name) > 0;
 
-				const string &col_name = col_path_info.full_path;
+			// Skip IN on text fields without .keyword (they cannot be pushed to Elasticsearch
+			// because the field is analyzed/tokenized). The guard filter mechanism (see
+			// ElasticsearchPushdownComplexFilter) prevents the FilterCombiner from re-pushing these.
+			if (is_text_field && !has_keyword_subfield) {
+				deferred = true;
+				return nullptr;
+			}
 
-				bool is_text_field = bind_data.schema.text_fields.count(col_name) > 0;
-				bool has_keyword_subfield = bind_data.schema.text_fields_with_keyword.count(col_name) > 0;
+			// Skip IN on geo fields (term/terms queries are invalid on geo_point/geo_shape).
+			// The guard filter mechanism prevents the FilterCombiner from re-pushing these.
+			if (schema.geo_fields.count(col_name) > 0) {
+				deferred = true;
+				return nullptr;
+			}
 
-				// Skip IN on text fields without .keyword (they cannot be pushed to Elasticsearch
-				// because the field is analyzed/tokenized). The guard filter mechanism (see after the loop)
-				// prevents the FilterCombiner from re-pushing these.
-				if (is_text_field && !has_keyword_subfield) {
-					has_deferred_filters = true;
-					continue;
+			// All IN values must be non-null constants.
+			vector<Value> in_values;
+			bool all_constants = true;
+			for (idx_t j = 1; j < op_expr.children.size(); j++) {
+				if (op_expr.children[j]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
+					all_constants = false;
+					break;
 				}
-
-				// Skip IN on geo fields (term/terms queries are invalid on geo_point/geo_shape).
-				// The guard filter mechanism prevents the FilterCombiner from re-pushing these.
-				if (bind_data.schema.geo_fields.count(col_name) > 0) {
-					has_deferred_filters = true;
-					continue;
+				auto &const_expr = op_expr.children[j]->Cast<BoundConstantExpression>();
+				if (const_expr.value.IsNull()) {
+					all_constants = false;
+					break;
 				}
+				in_values.push_back(const_expr.value);
+			}
 
-				// All IN values must be non-null constants.
-				vector<Value> in_values;
-				bool all_constants = true;
-				for (idx_t j = 1; j < op_expr.children.size(); j++) {
-					if (op_expr.children[j]->GetExpressionClass() != ExpressionClass::BOUND_CONSTANT) {
-						all_constants = false;
-						break;
-					}
-					auto &const_expr = op_expr.children[j]->Cast<BoundConstantExpression>();
-					if (const_expr.value.IsNull()) {
-						all_constants = false;
-						break;
-					}
-					in_values.push_back(const_expr.value);
+			if (!all_constants || in_values.empty()) {
+				return nullptr;
+			}
+
+			col_path = std::move(col_path_info);
+			return make_uniq<InFilter>(std::move(in_values));
+		}
+	}
+
+	return nullptr;
+}
+
+// Compiles predicates on computed expressions of numeric fields (arithmetic, comparisons and CASE), such as
+// bytes_out - bytes_in > 1000000, into the Painless source of a script query. Fields and constants are passed as
+// parameters (params.f<k> and params.c<k>), so equal predicates share the compiled script in Elasticsearch.
+//
+// Pushed filters are not evaluated again by DuckDB, so the script follows SQL's NULL semantics exactly. A numeric
+// value compiles to a Painless expression and a guard that is false when the value is NULL (a missing field, a
+// division by zero or a CASE branch that is NULL); the expression is only evaluated when the guard holds. A
+// predicate compiles to the conditions under which it is true and under which it is false, so that AND, OR, NOT
+// and CASE conditions combine them like three-valued logic. A NULL predicate matches neither way.
+struct PainlessScriptBuilder {
+	// A numeric value of Painless type long (DuckDB's signed integers) or double (FLOAT and DOUBLE). An empty
+	// guard means the value is never NULL. For longs, |value| <= 2^bits.
+	struct NumericValue {
+		string code;
+		string guard;
+		bool is_double = false;
+		idx_t bits = 0;
+	};
+	// A predicate, as the conditions under which it is true and false.
+	struct PredicateValue {
+		string when_true;
+		string when_false;
+	};
+
+	ClientContext &context;
+	const ElasticsearchSchema &schema;
+	const vector<ColumnIndex> &column_ids;
+	// Whether DuckDB divides doubles following IEEE 754 (x / 0 is infinite or NaN) instead of returning NULL.
+	bool ieee_division;
+
+	child_list_t<Value> params;
+	std::unordered_map<string, string> field_params;
+	idx_t const_count = 0;
+
+	PainlessScriptBuilder(ClientContext &context_p, const ElasticsearchSchema &schema_p,
+	                      const vector<ColumnIndex> &column_ids_p)
+	    : context(context_p), schema(schema_p), column_ids(column_ids_p) {
+		Value ieee_val;
+		ieee_division = !context.TryGetCurrentSetting("ieee_floating_point_ops", ieee_val) || ieee_val.IsNull() ||
+		                BooleanValue::Get(ieee_val);
+	}
+
+	static bool GetNumericType(const LogicalType &type, bool &is_double) {
+		switch (type.id()) {
+		case LogicalTypeId::TINYINT:
+		case LogicalTypeId::SMALLINT:
+		case LogicalTypeId::INTEGER:
+		case LogicalTypeId::BIGINT:
+			is_double = false;
+			return true;
+		case LogicalTypeId::FLOAT:
+		case LogicalTypeId::DOUBLE:
+			is_double = true;
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Painless computes integers as longs that wrap around on overflow (its Math class has no addExact), while
+	// DuckDB fails when a result exceeds the type of the expression, e.g. an INTEGER product beyond 2^31. Results
+	// with |value| <= 2^bits fit a signed type of n bytes when bits <= 8n - 2.
+	static bool FitsIntegerType(const NumericValue &value, const LogicalType &type) {
+		return value.is_double || value.bits <= GetTypeIdSize(type.InternalType()) * 8 - 2;
+	}
+
+	static idx_t GetMagnitudeBits(int64_t value) {
+		uint64_t magnitude = value < 0 ? uint64_t(0) - uint64_t(value) : uint64_t(value);
+		idx_t bits = 0;
+		while (bits < 63 && (uint64_t(1) << bits) < magnitude) {
+			bits++;
+		}
+		return bits;
+	}
+
+	static string AndConditions(const string &left, const string &right) {
+		if (left.empty() || right.empty()) {
+			return left.empty() ? right : left;
+		}
+		return left + " && " + right;
+	}
+
+	string AddConstant(const Value &value) {
+		string name = "c" + to_string(const_count++);
+		params.emplace_back(name, value);
+		return "params." + name;
+	}
+
+	// Reference a numeric field through its doc values. The field types match their DuckDB types, so that doc
+	// values hold the same numbers as the _source read by the scan (unlike half_float and scaled_float).
+	bool TranslateField(const Expression &expr, bool is_double, NumericValue &result) {
+		ColumnPathInfo col_path = ExtractColumnPath(expr, schema, column_ids);
+		if (!col_path.IsValid()) {
+			return false;
+		}
+		auto es_type = schema.es_type_map.find(col_path.full_path);
+		if (es_type == schema.es_type_map.end()) {
+			return false;
+		}
+		static const std::unordered_map<string, idx_t> long_types = {
+		    {"long", 63}, {"integer", 31}, {"short", 15}, {"byte", 7}};
+		static const std::set<string> double_types = {"double", "float"};
+		auto long_type = long_types.find(es_type->second);
+		if (is_double ? double_types.count(es_type->second) == 0 : long_type == long_types.end()) {
+			return false;
+		}
+
+		auto it = field_params.find(col_path.full_path);
+		if (it == field_params.end()) {
+			string name = "f" + to_string(field_params.size());
+			params.emplace_back(name, Value(col_path.full_path));
+			it = field_params.emplace(col_path.full_path, name).first;
+		}
+		string field = "doc[params." + it->second + "]";
+		result.code = field + ".value";
+		result.guard = field + ".size() != 0";
+		result.is_double = is_double;
+		result.bits = is_double ? 0 : long_type->second;
+		return true;
+	}
+
+	bool TranslateNumeric(const Expression &expr, NumericValue &result) {
+		bool is_double;
+		if (!GetNumericType(expr.return_type, is_double)) {
+			return false;
+		}
+		result.is_double = is_double;
+
+		if (expr.IsFoldable()) {
+			Value constant;
+			if (!ExpressionExecutor::TryEvaluateScalar(context, expr, constant)) {
+				return false;
+			}
+			if (constant.IsNull()) {
+				result.code = is_double ? "0.0" : "0";
+				result.guard = "false";
+				return true;
+			}
+			if (!constant.DefaultTryCastAs(is_double ? LogicalType::DOUBLE : LogicalType::BIGINT)) {
+				return false;
+			}
+			result.bits = is_double ? 0 : GetMagnitudeBits(BigIntValue::Get(constant));
+			result.code = AddConstant(constant);
+			return true;
+		}
+
+		if (TranslateField(expr, is_double, result)) {
+			return true;
+		}
+
+		switch (expr.GetExpressionClass()) {
+		case ExpressionClass::BOUND_CAST: {
+			// Widening casts between integers and casts to DOUBLE keep the value, other casts round or may fail.
+			auto &cast_expr = expr.Cast<BoundCastExpression>();
+			bool child_is_double;
+			if (!GetNumericType(cast_expr.child->return_type, child_is_double) ||
+			    (!is_double && (child_is_double || GetTypeIdSize(expr.return_type.InternalType()) <
+			                                           GetTypeIdSize(cast_expr.child->return_type.InternalType()))) ||
+			    (is_double && expr.return_type.id() != LogicalTypeId::DOUBLE)) {
+				return false;
+			}
+			if (!TranslateNumeric(*cast_expr.child, result)) {
+				return false;
+			}
+			if (is_double && !child_is_double) {
+				result.code = "((double) " + result.code + ")";
+			}
+			result.is_double = is_double;
+			return true;
+		}
+		case ExpressionClass::BOUND_FUNCTION:
+			return TranslateArithmetic(expr.Cast<BoundFunctionExpression>(), result);
+		case ExpressionClass::BOUND_CASE: {
+			// CASE WHEN c1 THEN v1 WHEN c2 THEN v2 ELSE v3 END -> (c1 ? v1 : (c2 ? v2 : v3)). The branches are cast
+			// to the type of the CASE by the binder.
+			auto &case_expr = expr.Cast<BoundCaseExpression>();
+			NumericValue else_value;
+			if (!TranslateNumeric(*case_expr.else_expr, else_value)) {
+				return false;
+			}
+			result.code = else_value.code;
+			result.guard = else_value.guard;
+			result.bits = else_value.bits;
+			for (idx_t i = case_expr.case_checks.size(); i > 0; i--) {
+				auto &check = case_expr.case_checks[i - 1];
+				PredicateValue when;
+				NumericValue then;
+				if (!TranslatePredicate(*check.when_expr, when) || !TranslateNumeric(*check.then_expr, then)) {
+					return false;
 				}
+				result.code = "(" + when.when_true + " ? " + then.code + " : " + result.code + ")";
+				result.bits = MaxValue(result.bits, then.bits);
+				if (!then.guard.empty() || !result.guard.empty()) {
+					result.guard = "(" + when.when_true + " ? " + (then.guard.empty() ? "true" : then.guard) + " : " +
+					               (result.guard.empty() ? "true" : result.guard) + ")";
+				}
+			}
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	bool TranslateArithmetic(const BoundFunctionExpression &func_expr, NumericValue &result) {
+		// DuckDB computes FLOAT arithmetic in single precision, Painless in double precision.
+		if (func_expr.return_type.id() == LogicalTypeId::FLOAT) {
+			return false;
+		}
+		const auto &name = func_expr.function.name;
+		if (func_expr.children.size() == 1 && (name == "-" || name == "subtract")) {
+			if (!TranslateNumeric(*func_expr.children[0], result)) {
+				return false;
+			}
+			result.code = "(-" + result.code + ")";
+			return FitsIntegerType(result, func_expr.return_type);
+		}
+		if (func_expr.children.size() != 2) {
+			return false;
+		}
 
-				if (!all_constants || in_values.empty()) {
-					continue;
+		string op;
+		bool is_division = false;
+		if (name == "+" || name == "add") {
+			op = " + ";
+		} else if (name == "-" || name == "subtract") {
+			op = " - ";
+		} else if (name == "*" || name == "multiply") {
+			op = " * ";
+		} else if (name == "/" || name == "divide" || name == "//") {
+			op = " / ";
+			is_division = true;
+		} else if ((name == "%" || name == "mod") && !result.is_double) {
+			op = " % ";
+			is_division = true;
+		} else {
+			return false;
+		}
+		if (name == "//" && result.is_double) {
+			return false;
+		}
+
+		NumericValue left, right;
+		if (!TranslateNumeric(*func_expr.children[0], left) || !TranslateNumeric(*func_expr.children[1], right) ||
+		    left.is_double != result.is_double || right.is_double != result.is_double) {
+			return false;
+		}
+		result.code = "(" + left.code + op + right.code + ")";
+		result.guard = AndConditions(left.guard, right.guard);
+
+		auto &divisor = *func_expr.children[1];
+		Value constant;
+		bool constant_divisor = is_division && divisor.IsFoldable() &&
+		                        ExpressionExecutor::TryEvaluateScalar(context, divisor, constant) &&
+		                        !constant.IsNull() && constant.DefaultTryCastAs(LogicalType::DOUBLE) &&
+		                        DoubleValue::Get(constant) != 0;
+		if (op == " * ") {
+			result.bits = left.bits + right.bits;
+		} else if (op == " / ") {
+			// Only Long.MIN_VALUE / -1 overflows. A constant divisor of magnitude 2 or more halves the dividend.
+			result.bits = constant_divisor && std::fabs(DoubleValue::Get(constant)) >= 2 && left.bits > 0
+			                  ? left.bits - 1
+			                  : left.bits;
+		} else if (op == " % ") {
+			result.bits = MinValue(left.bits, right.bits);
+		} else {
+			result.bits = MaxValue(left.bits, right.bits) + 1;
+		}
+		if (!FitsIntegerType(result, func_expr.return_type)) {
+			return false;
+		}
+
+		// A division by zero is NULL in DuckDB, unless doubles follow IEEE 754, which Painless does too but
+		// compares NaN differently. Divisions of longs by zero fail in Painless, so they are always guarded.
+		if (is_division) {
+			if (constant_divisor) {
+				return true;
+			}
+			if (result.is_double && ieee_division) {
+				return false;
+			}
+			result.guard = AndConditions(result.guard, right.code + (result.is_double ? " != 0.0" : " != 0"));
+		}
+		return true;
+	}
+
+	bool TranslatePredicate(const Expression &expr, PredicateValue &result) {
+		switch (expr.GetExpressionClass()) {
+		case ExpressionClass::BOUND_COMPARISON: {
+			auto &comp_expr = expr.Cast<BoundComparisonExpression>();
+			string op;
+			switch (expr.GetExpressionType()) {
+			case ExpressionType::COMPARE_EQUAL:
+				op = " == ";
+				break;
+			case ExpressionType::COMPARE_NOTEQUAL:
+				op = " != ";
+				break;
+			case ExpressionType::COMPARE_LESSTHAN:
+				op = " < ";
+				break;
+			case ExpressionType::COMPARE_GREATERTHAN:
+				op = " > ";
+				break;
+			case ExpressionType::COMPARE_LESSTHANOREQUALTO:
+				op = " <= ";
+				break;
+			case ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+				op = " >= ";
+				break;
+			default:
+				return false;
+			}
+			NumericValue left, right;
+			if (!TranslateNumeric(*comp_expr.left, left) || !TranslateNumeric(*comp_expr.right, right)) {
+				return false;
+			}
+			SetComparison(AndConditions(left.guard, right.guard), "(" + left.code + op + right.code + ")", result);
+			return true;
+		}
+		case ExpressionClass::BOUND_BETWEEN: {
+			auto &between_expr = expr.Cast<BoundBetweenExpression>();
+			NumericValue input, lower, upper;
+			if (!TranslateNumeric(*between_expr.input, input) || !TranslateNumeric(*between_expr.lower, lower) ||
+			    !TranslateNumeric(*between_expr.upper, upper)) {
+				return false;
+			}
+			string comparison = "(" + input.code + (between_expr.lower_inclusive ? " >= " : " > ") + lower.code +
+			                    " && " + input.code + (between_expr.upper_inclusive ? " <= " : " < ") + upper.code +
+			                    ")";
+			SetComparison(AndConditions(AndConditions(input.guard, lower.guard), upper.guard), comparison, result);
+			return true;
+		}
+		case ExpressionClass::BOUND_CONJUNCTION: {
+			// a AND b is true if both are true and false if either is false, OR the other way around.
+			auto &conj_expr = expr.Cast<BoundConjunctionExpression>();
+			bool is_and = expr.GetExpressionType() == ExpressionType::CONJUNCTION_AND;
+			vector<string> when_true, when_false;
+			for (auto &child : conj_expr.children) {
+				PredicateValue child_value;
+				if (!TranslatePredicate(*child, child_value)) {
+					return false;
 				}
+				when_true.push_back(child_value.when_true);
+				when_false.push_back(child_value.when_false);
+			}
+			result.when_true = "(" + StringUtil::Join(when_true, is_and ? " && " : " || ") + ")";
+			result.when_false = "(" + StringUtil::Join(when_false, is_and ? " || " : " && ") + ")";
+			return true;
+		}
+		case ExpressionClass::BOUND_OPERATOR: {
+			auto &op_expr = expr.Cast<BoundOperatorExpression>();
+			if (op_expr.children.size() != 1) {
+				return false;
+			}
+			if (expr.GetExpressionType() == ExpressionType::OPERATOR_NOT) {
+				if (!TranslatePredicate(*op_expr.children[0], result)) {
+					return false;
+				}
+				std::swap(result.when_true, result.when_false);
+				return true;
+			}
+			bool is_null = expr.GetExpressionType() == ExpressionType::OPERATOR_IS_NULL;
+			NumericValue value;
+			if ((!is_null && expr.GetExpressionType() != ExpressionType::OPERATOR_IS_NOT_NULL) ||
+			    !TranslateNumeric(*op_expr.children[0], value)) {
+				return false;
+			}
+			string when_not_null = value.guard.empty() ? "true" : "(" + value.guard + ")";
+			string when_null = value.guard.empty() ? "false" : "!" + when_not_null;
+			result.when_true = is_null ? when_null : when_not_null;
+			result.when_false = is_null ? when_not_null : when_null;
+			return true;
+		}
+		default:
+			return false;
+		}
+	}
+
+	static void SetComparison(const string &guard, const string &comparison, PredicateValue &result) {
+		if (guard.empty()) {
+			result.when_true = comparison;
+			result.when_false = "!" + comparison;
+			return;
+		}
+		result.when_true = "(" + guard + " && " + comparison + ")";
+		result.when_false = "(" + guard + " && !" + comparison + ")";
+	}
+};
+
+// Try to create a script query for a predicate on computed expressions of numeric fields (see
+// PainlessScriptBuilder), or for its negation. Only with the elasticsearch_enable_script_pushdown setting, since
+// scripts run for every document that the other clauses of the query match, trading server CPU for network.
+// AND/OR/NOT trees are left to TryCreateBooleanFilter, so that only their leaves without a query become scripts.
+static unique_ptr<ElasticsearchBooleanFilter> TryCreateScriptFilter(ClientContext &context, const Expression &expr,
+                                                                    bool negated, const ElasticsearchSchema &schema,
+                                                                    const vector<ColumnIndex> &column_ids) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_CONJUNCTION ||
+	    expr.GetExpressionType() == ExpressionType::OPERATOR_NOT) {
+		return nullptr;
+	}
+	Value setting_val;
+	if (!context.TryGetCurrentSetting("elasticsearch_enable_script_pushdown", setting_val) ||
+	    !BooleanValue::Get(setting_val)) {
+		return nullptr;
+	}
+
+	PainlessScriptBuilder builder(context, schema, column_ids);
+	PainlessScriptBuilder::PredicateValue predicate;
+	if (!builder.TranslatePredicate(expr, predicate) || builder.field_params.empty()) {
+		return nullptr;
+	}
+
+	auto result = make_uniq<ElasticsearchBooleanFilter>();
+	result->script = negated ? predicate.when_false : predicate.when_true;
+	result->script_params = std::move(builder.params);
+	return result;
+}
+
+static unique_ptr<ElasticsearchBooleanFilter> TryCreateNestedFilter(ClientContext &context, const Expression &expr,
+                                                                    const ElasticsearchSchema &schema,
+                                                                    const vector<ColumnIndex> &column_ids,
+                                                                    bool &exact);
+
+// Try to create a boolean predicate tree for an AND/OR/NOT expression over one or more columns.
+// Negations are pushed down to the leaves with De Morgan's laws, which hold in SQL's three-valued logic as well:
+// NOT (a OR b) = NOT a AND NOT b and NOT (a AND b) = NOT a OR NOT b. A negated leaf only matches documents where
+// its field exists (see ElasticsearchBooleanFilter::negated), except for IS NULL / IS NOT NULL, which are flipped.
+// Leaves that are no single-column filter may become script queries (see TryCreateScriptFilter).
+//
+// Children of AND that cannot be translated are left out, the tree then matches a superset of the rows and exact
+// is set to false so that DuckDB keeps evaluating the whole expression. A child of OR that cannot be translated
+// makes the whole OR untranslatable. Returns nullptr if nothing can be pushed.
+static unique_ptr<ElasticsearchBooleanFilter> TryCreateBooleanFilter(ClientContext &context, const Expression &expr,
+                                                                     bool negated, const ElasticsearchSchema &schema,
+                                                                     const vector<ColumnIndex> &column_ids,
+                                                                     bool &exact) {
+	if (expr.GetExpressionType() == ExpressionType::OPERATOR_NOT) {
+		auto &not_expr = expr.Cast<BoundOperatorExpression>();
+		if (not_expr.children.size() != 1) {
+			return nullptr;
+		}
+		return TryCreateBooleanFilter(context, *not_expr.children[0], !negated, schema, column_ids, exact);
+	}
 
-				unique_ptr<TableFilter> in_filter = make_uniq<InFilter>(std::move(in_values));
-				if (!col_path_info.nested_fields.empty()) {
-					in_filter = WrapInStructFilters(std::move(in_filter), col_path_info.nested_fields);
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_CONJUNCTION) {
+		auto &conj_expr = expr.Cast<BoundConjunctionExpression>();
+		bool is_or = conj_expr.GetExpressionType() == ExpressionType::CONJUNCTION_OR;
+		if (negated) {
+			is_or = !is_or;
+		}
+
+		auto result = make_uniq<ElasticsearchBooleanFilter>();
+		result->type = is_or ? ExpressionType::CONJUNCTION_OR : ExpressionType::CONJUNCTION_AND;
+		for (auto &child : conj_expr.children) {
+			auto child_filter = TryCreateBooleanFilter(context, *child, negated, schema, column_ids, exact);
+			if (!child_filter) {
+				if (is_or) {
+					return nullptr;
 				}
+				exact = false;
+				continue;
+			}
+			result->children.push_back(std::move(child_filter));
+		}
+		if (result->children.empty()) {
+			return nullptr;
+		}
+		if (result->children.size() == 1) {
+			return std::move(result->children[0]);
+		}
+		return result;
+	}
+
+	if (!negated) {
+		auto nested_filter = TryCreateNestedFilter(context, expr, schema, column_ids, exact);
+		if (nested_filter) {
+			return nested_filter;
+		}
+	} else if (IsListValuePredicate(expr)) {
+		return nullptr;
+	}
+
+	ColumnPathInfo col_path;
+	bool deferred = false;
+	auto filter = TryCreateTableFilter(context, expr, schema, column_ids, col_path, deferred);
+	if (!filter) {
+		return deferred ? nullptr : TryCreateScriptFilter(context, expr, negated, schema, column_ids);
+	}
+
+	auto result = make_uniq<ElasticsearchBooleanFilter>();
+	result->column_name = std::move(col_path.full_path);
+	if (negated && filter->filter_type == TableFilterType::IS_NULL) {
+		result->filter = make_uniq<IsNotNullFilter>();
+	} else if (negated && filter->filter_type == TableFilterType::IS_NOT_NULL) {
+		result->filter = make_uniq<IsNullFilter>();
+	} else {
+		result->filter = std::move(filter);
+		result->negated = negated;
+	}
+	return result;
+}
+
+// Replace the references to the element of a list lambda with a copy of the list column, so that a field of the
+// element becomes a struct_extract chain on the column that ExtractColumnPath resolves to the path of the field.
+// Returns false if the lambda references anything else (its index parameter or captured columns).
+static bool ReplaceLambdaElementReferences(unique_ptr<Expression> &expr, const Expression &list_expr) {
+	if (expr->GetExpressionClass() == ExpressionClass::BOUND_REF) {
+		if (expr->Cast<BoundReferenceExpression>().index != 0) {
+			return false;
+		}
+		expr = list_expr.Copy();
+		return true;
+	}
+	bool replaced = true;
+	ExpressionIterator::EnumerateChildren(*expr, [&](unique_ptr<Expression> &child) {
+		replaced = replaced && ReplaceLambdaElementReferences(child, list_expr);
+	});
+	return replaced;
+}
 
-				get.table_filters.PushFilter(ProjectionIndex(col_path_info.output_col_idx), std::move(in_filter));
+// Try to create a boolean predicate tree for a predicate on the documents of a nested field, written as a test of
+// the filtered list for values: len(list_filter(users, lambda u: u.email = 'x' AND u.name = 'y')) > 0. All the
+// conditions of the lambda must hold for the same nested document, so the tree is wrapped in a nested query (see
+// ElasticsearchBooleanFilter::nested_path). Negations are not pushed: the list is empty for documents without
+// nested documents, which Elasticsearch does not tell apart from missing fields. Returns nullptr if the expression
+// is not such a predicate or nothing of it can be pushed.
+static unique_ptr<ElasticsearchBooleanFilter> TryCreateNestedFilter(ClientContext &context, const Expression &expr,
+                                                                    const ElasticsearchSchema &schema,
+                                                                    const vector<ColumnIndex> &column_ids,
+                                                                    bool &exact) {
+	if (expr.GetExpressionClass() != ExpressionClass::BOUND_COMPARISON) {
+		return nullptr;
+	}
+	auto len_expr = GetNonEmptyListLength(expr.Cast<BoundComparisonExpression>());
+	if (!len_expr || len_expr->children[0]->GetExpressionClass() != ExpressionClass::BOUND_FUNCTION) {
+		return nullptr;
+	}
+
+	// list_filter(col, lambda) with the lambda in the bind data. Captured columns would be additional children.
+	auto &filter_expr = len_expr->children[0]->Cast<BoundFunctionExpression>();
+	const auto &func_name = filter_expr.function.name;
+	if ((func_name != "list_filter" && func_name != "array_filter" && func_name != "filter") ||
+	    filter_expr.children.size() != 1 || !filter_expr.bind_info) {
+		return nullptr;
+	}
+	auto &lambda_bind_data = filter_expr.bind_info->Cast<ListLambdaBindData>();
+	if (!lambda_bind_data.lambda_expr || lambda_bind_data.has_index) {
+		return nullptr;
+	}
+
+	auto &list_expr = *filter_expr.children[0];
+	ColumnPathInfo col_path_info = ExtractColumnPath(list_expr, schema, column_ids);
+	if (!col_path_info.IsValid()) {
+		return nullptr;
+	}
+	auto es_type = schema.es_type_map.find(col_path_info.full_path);
+	if (es_type == schema.es_type_map.end() || es_type->second != "nested") {
+		return nullptr;
+	}
+
+	auto condition = lambda_bind_data.lambda_expr->Copy();
+	if (!ReplaceLambdaElementReferences(condition, list_expr)) {
+		return nullptr;
+	}
+
+	bool condition_exact = true;
+	auto result = TryCreateBooleanFilter(context, *condition, false, schema, column_ids, condition_exact);
+	if (!result) {
+		return nullptr;
+	}
+
+	// Every leaf must be a field of the nested documents.
+	string path_prefix = col_path_info.full_path + ".";
+	std::function<bool(const ElasticsearchBooleanFilter &)> is_below_path = [&](const ElasticsearchBooleanFilter &node) {
+		if (node.type == ExpressionType::INVALID) {
+			return StringUtil::StartsWith(node.column_name, path_prefix);
+		}
+		for (auto &child : node.children) {
+			if (!is_below_path(*child)) {
+				return false;
+			}
+		}
+		return true;
+	};
+	if (!is_below_path(*result)) {
+		return nullptr;
+	}
+
+	if (!condition_exact) {
+		exact = false;
+	}
+	result->nested_path = std::move(col_path_info.full_path);
+	return result;
+}
+
+// Check whether an expression references the _score virtual column. Scores are computed by Elasticsearch for the
+// whole query, so filters on them can only be evaluated by DuckDB.
+static bool ReferencesScoreColumn(const Expression &expr, const vector<ColumnIndex> &column_ids) {
+	if (expr.GetExpressionClass() == ExpressionClass::BOUND_COLUMN_REF) {
+		idx_t output_col_idx = expr.Cast<BoundColumnRefExpression>().binding.column_index.GetIndexUnsafe();
+		return output_col_idx < column_ids.size() &&
+		       column_ids[output_col_idx].GetPrimaryIndex() == ELASTICSEARCH_SCORE_COLUMN_ID;
+	}
+	bool references_score = false;
+	ExpressionIterator::EnumerateChildren(expr, [&](const Expression &child) {
+		references_score = references_score || ReferencesScoreColumn(child, column_ids);
+	});
+	return references_score;
+}
+
+// Pushdown complex filter callback.
+// Processes all filter expressions in a single pass. Filters on a single column (see TryCreateTableFilter) are
+// pushed into get.table_filters and AND/OR/NOT trees of such filters, possibly over several columns, into the
+// boolean filters of the bind data (see TryCreateBooleanFilter). Both are consumed from the filters vector,
+// except for trees of which only a superset could be pushed.
+// This approach handles everything in one pass, avoiding the issue where pushing to table_filters
+// in pushdown_complex_filter causes DuckDB's optimizer to skip the FilterCombiner path,
+// which would prevent standard comparison filters from being pushed down.
+//
+// For text fields without a .keyword subfield, comparison/LIKE/ILIKE/IN filters are not
+// pushed - they are left for DuckDB's FILTER stage, as are filters on the _score virtual column.
+// For geo fields (geo_point, geo_shape), equality/inequality and IN are deferred to DuckDB's FILTER
+// stage, while range comparisons are rejected with an error. When such filters are deferred and
+// no other filters have been pushed into table_filters, a no-op IsNotNullFilter on _id is injected as a guard.
+// This causes DuckDB's FilterCombiner (which runs after this callback) to see a non-empty
+// table_filters and skip its own pushdown, preventing it from re-pushing the deferred filters
+// as ConstantFilter/InFilter. The guard is optimized away by the optimizer extension
+// (OptimizeIdFilters in elasticsearch_optimizer.cpp) as part of the general _id semantic
+// optimization: _id IS NOT NULL is always true, so it is stripped. TranslateFilters also
+// skips _id null filters as defense-in-depth.
+static void ElasticsearchPushdownComplexFilter(ClientContext &context, LogicalGet &get, FunctionData *bind_data_p,
+                                               vector<unique_ptr<Expression>> &filters) {
+	auto &bind_data = bind_data_p->Cast<ElasticsearchQueryBindData>();
+	const auto &column_ids = get.GetColumnIds();
+
+	// Track whether any filters were deferred to DuckDB (e.g. comparisons/IN on text fields without
+	// .keyword or geo fields). Used to decide whether a guard filter is needed - see comment block
+	// after the loop.
+	bool has_deferred_filters = false;
+
+	for (idx_t i = 0; i < filters.size(); i++) {
+		auto &filter = filters[i];
+		if (!filter) {
+			continue;
+		}
+		if (ReferencesScoreColumn(*filter, column_ids)) {
+			has_deferred_filters = true;
+			continue;
+		}
+
+		ColumnPathInfo col_path;
+		bool deferred = false;
+		auto table_filter = TryCreateTableFilter(context, *filter, bind_data.schema, column_ids, col_path, deferred);
+		if (table_filter) {
+			if (!col_path.nested_fields.empty()) {
+				table_filter = WrapInStructFilters(std::move(table_filter), col_path.nested_fields);
+			}
+			get.table_filters.PushFilter(ProjectionIndex(col_path.output_col_idx), std::move(table_filter));
+			filters[i] = nullptr;
+			continue;
+		}
+		if (deferred) {
+			has_deferred_filters = true;
+			continue;
+		}
+
+		// Handle predicates on the documents of nested fields. If only a superset could be pushed, the expression
+		// stays in DuckDB's FILTER stage.
+		bool nested_exact = true;
+		auto nested_filter = TryCreateNestedFilter(context, *filter, bind_data.schema, column_ids, nested_exact);
+		if (nested_filter) {
+			if (nested_exact) {
 				filters[i] = nullptr;
-				continue;
+			} else {
+				has_deferred_filters = true;
+			}
+			bind_data.boolean_filters.push_back(std::move(nested_filter));
+			continue;
+		}
+
+		// Handle predicates on computed expressions of numeric fields, evaluated by a script.
+		auto script_filter = TryCreateScriptFilter(context, *filter, false, bind_data.schema, column_ids);
+		if (script_filter) {
+			filters[i] = nullptr;
+			bind_data.boolean_filters.push_back(std::move(script_filter));
+			continue;
+		}
+
+		// Handle AND/OR/NOT trees, possibly over several columns. If only a superset could be pushed,
+		// the expression stays in DuckDB's FILTER stage, which must then not be re-pushed by the FilterCombiner.
+		if (filter->GetExpressionClass() == ExpressionClass::BOUND_CONJUNCTION ||
+		    filter->GetExpressionType() == ExpressionType::OPERATOR_NOT) {
+			bool exact = true;
+			auto boolean_filter = TryCreateBooleanFilter(context, *filter, false, bind_data.schema, column_ids, exact);
+			if (!boolean_filter || !exact) {
+				has_deferred_filters = true;
+			} else {
+				filters[i] = nullptr;
+			}
+			if (boolean_filter) {
+				bind_data.boolean_filters.push_back(std::move(boolean_filter));
 			}
 		}
 	}
@@ -1631,6 +2936,27 @@ static void ElasticsearchPushdownComplexFilter(ClientContext &context, LogicalGe
 	    filters.end());
 }
 
+// Cardinality estimate for DuckDB's optimizer: the number of documents matching the base query, counted when the
+// schema was sampled. Without it the scan is estimated at a single row and becomes the build side of hash joins, so
+// join filters from a small local table could not be pushed into it.
+static unique_ptr<NodeStatistics> ElasticsearchQueryCardinality(ClientContext &context,
+                                                                const FunctionData *bind_data_p) {
+	auto &bind_data = bind_data_p->Cast<ElasticsearchQueryBindData>();
+	if (bind_data.schema.document_count < 0) {
+		return nullptr;
+	}
+	auto document_count = static_cast<idx_t>(bind_data.schema.document_count);
+	return make_uniq<NodeStatistics>(document_count, document_count);
+}
+
+// The _score virtual column, only present in the output if selected explicitly.
+static virtual_column_map_t ElasticsearchQueryGetVirtualColumns(ClientContext &context,
+                                                                optional_ptr<FunctionData> bind_data) {
+	virtual_column_map_t result;
+	result.insert(make_pair(ELASTICSEARCH_SCORE_COLUMN_ID, TableColumn("_score", LogicalType::DOUBLE)));
+	return result;
+}
+
 void RegisterElasticsearchQueryFunction(ExtensionLoader &loader) {
 	TableFunction elasticsearch_query("elasticsearch_query", {}, ElasticsearchQueryScan, ElasticsearchQueryBind,
 	                                  ElasticsearchQueryInitGlobal);
@@ -1640,25 +2966,39 @@ void RegisterElasticsearchQueryFunction(ExtensionLoader &loader) {
 	elasticsearch_query.filter_pushdown = true;
 	elasticsearch_query.filter_prune = true;
 	elasticsearch_query.pushdown_complex_filter = ElasticsearchPushdownComplexFilter;
+	elasticsearch_query.get_virtual_columns = ElasticsearchQueryGetVirtualColumns;
+	elasticsearch_query.cardinality = ElasticsearchQueryCardinality;
 
 	// Named parameters.
-	elasticsearch_query.named_parameters["host"] = LogicalType::VARCHAR;
-	elasticsearch_query.named_parameters["port"] = LogicalType::INTEGER;
+	AddElasticsearchConfigParameters(elasticsearch_query);
 	elasticsearch_query.named_parameters["index"] = LogicalType::VARCHAR;
 	elasticsearch_query.named_parameters["query"] = LogicalType::VARCHAR;
-	elasticsearch_query.named_parameters["username"] = LogicalType::VARCHAR;
-	elasticsearch_query.named_parameters["password"] = LogicalType::VARCHAR;
-	elasticsearch_query.named_parameters["use_ssl"] = LogicalType::BOOLEAN;
-	elasticsearch_query.named_parameters["verify_ssl"] = LogicalType::BOOLEAN;
-	elasticsearch_query.named_parameters["timeout"] = LogicalType::INTEGER;
-	elasticsearch_query.named_parameters["max_retries"] = LogicalType::INTEGER;
-	elasticsearch_query.named_parameters["retry_interval"] = LogicalType::INTEGER;
-	elasticsearch_query.named_parameters["retry_backoff_factor"] = LogicalType::DOUBLE;
 	elasticsearch_query.named_parameters["sample_size"] = LogicalType::INTEGER;
 
 	loader.RegisterFunction(elasticsearch_query);
 }
 
+// Full-text predicates are only evaluated by Elasticsearch. This is reached when pushdown_complex_filter could not
+// push the predicate, e.g. outside of a WHERE clause, on a table other than an elasticsearch_query scan or in an OR
+// with a filter that cannot be pushed.
+static void ElasticsearchFullTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &func_expr = state.expr.Cast<BoundFunctionExpression>();
+	throw InvalidInputException("%s can only be used as a filter on a column of an elasticsearch_query scan that is "
+	                            "pushed down to Elasticsearch",
+	                            func_expr.function.name);
+}
+
+void RegisterElasticsearchFullTextFunctions(ExtensionLoader &loader) {
+	// es_match(field, query): match query, the query text is analyzed and any term may match.
+	// es_match_phrase(field, query): match_phrase query, the terms must appear next to each other in order.
+	// es_query_string(field, query): query_string query in the Lucene query syntax, with field as the default field.
+	for (auto name : {"es_match", "es_match_phrase", "es_query_string"}) {
+		ScalarFunction function(name, {LogicalType::ANY, LogicalType::VARCHAR}, LogicalType::BOOLEAN,
+		                        ElasticsearchFullTextFunction);
+		loader.RegisterFunction(function);
+	}
+}
+
 // Helper function for the optimizer extension to set limit/offset in bind data.
 // Called from elasticsearch_optimizer.cpp after verifying the function name is "elasticsearch_query".
 void SetElasticsearchLimitOffset(FunctionData &bind_data, int64_t limit, int64_t offset) {
@@ -5,6 +5,7 @@
 #include "duckdb/main/client_context.hpp"
 #include "yyjson.hpp"
 
+#include <cstdlib>
 #include <functional>
 #include <map>
 #include <mutex>
@@ -26,6 +27,7 @@ struct MergedFieldInfo {
 struct SampleResult {
 	std::set<std::string> array_fields; // fields detected as containing arrays
 	bool has_unmapped_fields;           // whether any unmapped fields were found in the sample
+	int64_t total_hits = -1;            // number of documents matching the sampling query (-1 if unknown)
 };
 
 // Forward declaration for mutual recursion: BuildStructTypeFromProperties calls BuildDuckDBTypeFromMapping.
@@ -220,11 +222,10 @@ static void CollectAllPathTypes(yyjson_val *properties, const std::string &prefi
 	}
 }
 
-// Collect text fields that have a .keyword subfield.
-// These text fields can be filtered via the .keyword subfield which stores the raw
-// (not analyzed) value. Text fields without .keyword cannot be filtered (except IS NULL/IS NOT NULL).
-static void CollectTextFieldsWithKeyword(yyjson_val *properties, const std::string &prefix,
-                                         std::unordered_set<std::string> &text_fields_with_keyword) {
+// Collect the multi-fields ("fields" in the mapping) of all fields, including nested ones. When several indices
+// match, the multi-fields of the first index that defines the field are used.
+static void CollectSubfields(yyjson_val *properties, const std::string &prefix,
+                             std::unordered_map<std::string, vector<ElasticsearchSubfield>> &subfields) {
 	if (!properties || !yyjson_is_obj(properties))
 		return;
 
@@ -238,33 +239,110 @@ static void CollectTextFieldsWithKeyword(yyjson_val *properties, const std::stri
 
 		std::string full_path = prefix.empty() ? field_name : prefix + "." + field_name;
 
-		// Check if this is a text field with a .keyword subfield.
-		yyjson_val *type_val = yyjson_obj_get(field_def, "type");
-		if (type_val && yyjson_is_str(type_val)) {
-			const char *type_str = yyjson_get_str(type_val);
-			if (type_str && std::string(type_str) == "text") {
-				// Check for "fields" property containing a "keyword" subfield.
-				yyjson_val *fields = yyjson_obj_get(field_def, "fields");
-				if (fields && yyjson_is_obj(fields)) {
-					yyjson_val *keyword_field = yyjson_obj_get(fields, "keyword");
-					if (keyword_field && yyjson_is_obj(keyword_field)) {
-						// Verify it's actually a keyword type.
-						yyjson_val *keyword_type = yyjson_obj_get(keyword_field, "type");
-						if (keyword_type && yyjson_is_str(keyword_type)) {
-							const char *kt = yyjson_get_str(keyword_type);
-							if (kt && std::string(kt) == "keyword") {
-								text_fields_with_keyword.insert(full_path);
-							}
-						}
-					}
+		yyjson_val *fields = yyjson_obj_get(field_def, "fields");
+		if (fields && yyjson_is_obj(fields) && !subfields.count(full_path)) {
+			auto &field_subfields = subfields[full_path];
+			yyjson_obj_iter subfield_iter;
+			yyjson_obj_iter_init(fields, &subfield_iter);
+			yyjson_val *subfield_key;
+			while ((subfield_key = yyjson_obj_iter_next(&subfield_iter))) {
+				yyjson_val *subfield_def = yyjson_obj_iter_get_val(subfield_key);
+				const char *subfield_type = yyjson_get_str(yyjson_obj_get(subfield_def, "type"));
+				if (!subfield_type) {
+					continue;
 				}
+				ElasticsearchSubfield subfield;
+				subfield.path = full_path + "." + yyjson_get_str(subfield_key);
+				subfield.es_type = subfield_type;
+				const char *normalizer = yyjson_get_str(yyjson_obj_get(subfield_def, "normalizer"));
+				subfield.normalizer = normalizer ? normalizer : "";
+				const char *analyzer = yyjson_get_str(yyjson_obj_get(subfield_def, "analyzer"));
+				subfield.analyzer = analyzer ? analyzer : "";
+				field_subfields.push_back(std::move(subfield));
 			}
 		}
 
 		// Recursively collect nested paths for object/nested types.
 		yyjson_val *nested_props = yyjson_obj_get(field_def, "properties");
 		if (nested_props && yyjson_is_obj(nested_props)) {
-			CollectTextFieldsWithKeyword(nested_props, full_path, text_fields_with_keyword);
+			CollectSubfields(nested_props, full_path, subfields);
+		}
+	}
+}
+
+// Collect the keyword fields and subfields that set ignore_above, and the fields that set a normalizer, in any of
+// the matching indices. Normalizers of multi-fields are part of the subfields.
+static void CollectDocValueLimitedFields(yyjson_val *properties, const std::string &prefix,
+                                         std::unordered_set<std::string> &ignore_above_fields,
+                                         std::unordered_set<std::string> &normalized_fields) {
+	if (!properties || !yyjson_is_obj(properties))
+		return;
+
+	yyjson_obj_iter iter;
+	yyjson_obj_iter_init(properties, &iter);
+	yyjson_val *key;
+
+	while ((key = yyjson_obj_iter_next(&iter))) {
+		const char *field_name = yyjson_get_str(key);
+		yyjson_val *field_def = yyjson_obj_iter_get_val(key);
+
+		std::string full_path = prefix.empty() ? field_name : prefix + "." + field_name;
+		if (yyjson_obj_get(field_def, "ignore_above")) {
+			ignore_above_fields.insert(full_path);
+		}
+		if (yyjson_obj_get(field_def, "normalizer")) {
+			normalized_fields.insert(full_path);
+		}
+
+		yyjson_val *fields = yyjson_obj_get(field_def, "fields");
+		if (fields && yyjson_is_obj(fields)) {
+			yyjson_obj_iter subfield_iter;
+			yyjson_obj_iter_init(fields, &subfield_iter);
+			yyjson_val *subfield_key;
+			while ((subfield_key = yyjson_obj_iter_next(&subfield_iter))) {
+				if (yyjson_obj_get(yyjson_obj_iter_get_val(subfield_key), "ignore_above")) {
+					ignore_above_fields.insert(full_path + "." + yyjson_get_str(subfield_key));
+				}
+			}
+		}
+
+		// Recursively collect nested paths for object/nested types.
+		yyjson_val *nested_props = yyjson_obj_get(field_def, "properties");
+		if (nested_props && yyjson_is_obj(nested_props)) {
+			CollectDocValueLimitedFields(nested_props, full_path, ignore_above_fields, normalized_fields);
+		}
+	}
+}
+
+// Choose the subfields that predicates on a field are translated to (see ElasticsearchSchema::keyword_subfields):
+// - a keyword subfield without a normalizer stores the raw value, .keyword is preferred over other names (.raw)
+// - a keyword subfield with the built-in lowercase normalizer indexes the values and normalizes the query terms in
+//   lowercase. Custom normalizers are skipped, their filters are defined in the index settings.
+// - a wildcard subfield answers wildcard and regexp queries with an n-gram index instead of scanning all terms
+// Text subfields (e.g. with an n-gram analyzer) are not used: their matches depend on the analyzer and are not
+// exact, so the filters could not be removed from DuckDB.
+static void SelectSubfieldTargets(ElasticsearchSchema &schema) {
+	for (const auto &entry : schema.subfields) {
+		const string &field_path = entry.first;
+		for (const auto &subfield : entry.second) {
+			if (subfield.es_type == "keyword" && subfield.normalizer.empty()) {
+				bool is_preferred = subfield.path == field_path + ".keyword";
+				if (is_preferred || !schema.keyword_subfields.count(field_path)) {
+					schema.keyword_subfields[field_path] = subfield.path;
+				}
+			} else if (subfield.es_type == "keyword" && subfield.normalizer == "lowercase") {
+				schema.lowercase_subfields.emplace(field_path, subfield.path);
+			} else if (subfield.es_type == "wildcard") {
+				schema.wildcard_subfields.emplace(field_path, subfield.path);
+			}
+		}
+	}
+
+	// Text fields with a keyword subfield can be filtered on its raw values.
+	for (const auto &entry : schema.keyword_subfields) {
+		auto es_type = schema.es_type_map.find(entry.first);
+		if (es_type != schema.es_type_map.end() && es_type->second == "text") {
+			schema.text_fields_with_keyword.insert(entry.first);
 		}
 	}
 }
@@ -523,6 +601,15 @@ static SampleResult SampleDocuments(ElasticsearchClient &client, const std::stri
 	yyjson_val *hits_obj = yyjson_obj_get(root, "hits");
 	yyjson_val *hits_array = hits_obj ? yyjson_obj_get(hits_obj, "hits") : nullptr;
 
+	// hits.total is {"value": N, "relation": "eq"} (a plain number before Elasticsearch 7).
+	yyjson_val *total = hits_obj ? yyjson_obj_get(hits_obj, "total") : nullptr;
+	if (total && yyjson_is_obj(total)) {
+		total = yyjson_obj_get(total, "value");
+	}
+	if (total && yyjson_is_int(total)) {
+		result.total_hits = yyjson_get_sint(total);
+	}
+
 	if (hits_array && yyjson_is_arr(hits_array)) {
 		size_t idx, max;
 		yyjson_val *hit;
@@ -568,6 +655,40 @@ static SampleResult SampleDocuments(ElasticsearchClient &client, const std::stri
 	return result;
 }
 
+// Get the lowest index.max_terms_count setting of the indices matching index. Indices without the setting use the
+// default. If the settings cannot be read (e.g. missing privileges), the default is assumed.
+static int64_t GetMaxTermsCount(ElasticsearchClient &client, const std::string &index) {
+	int64_t max_terms_count = ElasticsearchSchema::DEFAULT_MAX_TERMS_COUNT;
+	auto response = client.GetSetting(index, "index.max_terms_count");
+	if (!response.success) {
+		return max_terms_count;
+	}
+
+	yyjson_doc *doc = yyjson_read(response.body.c_str(), response.body.size(), 0);
+	if (!doc) {
+		return max_terms_count;
+	}
+
+	// {"index-name": {"settings": {"index.max_terms_count": "1000"}}, ...}
+	yyjson_val *root = yyjson_doc_get_root(doc);
+	yyjson_obj_iter idx_iter;
+	yyjson_obj_iter_init(root, &idx_iter);
+	yyjson_val *idx_key;
+	while ((idx_key = yyjson_obj_iter_next(&idx_iter))) {
+		yyjson_val *settings = yyjson_obj_get(yyjson_obj_iter_get_val(idx_key), "settings");
+		yyjson_val *setting = settings ? yyjson_obj_get(settings, "index.max_terms_count") : nullptr;
+		if (setting && yyjson_is_str(setting)) {
+			int64_t value = std::strtoll(yyjson_get_str(setting), nullptr, 10);
+			if (value > 0 && value < max_terms_count) {
+				max_terms_count = value;
+			}
+		}
+	}
+
+	yyjson_doc_free(doc);
+	return max_terms_count;
+}
+
 // Thread-safe per-process cache for resolved Elasticsearch schemas.
 // Prevents redundant mapping and sampling HTTP requests when DuckDB calls bind multiple times
 // with the same parameters (e.g. UNPIVOT ... ON COLUMNS(*), CTEs referenced multiple times etc.)
@@ -673,7 +794,8 @@ ElasticsearchSchema ResolveElasticsearchSchema(const ElasticsearchConfig &config
 	                         result.all_mapped_paths);
 
 	// Collect all path types including nested paths (needed for filter pushdown on nested struct fields).
-	// Also collect text fields that have a .keyword subfield (needed for filter pushdown on text fields).
+	// Also collect the multi-fields (needed for filter pushdown on text fields and for choosing query targets) and
+	// the fields with ignore_above (not usable for sorting and aggregations).
 	std::unordered_map<std::string, std::string> all_path_types;
 	yyjson_obj_iter idx_iter;
 	yyjson_obj_iter_init(root, &idx_iter);
@@ -685,7 +807,8 @@ ElasticsearchSchema ResolveElasticsearchSchema(const ElasticsearchConfig &config
 			yyjson_val *properties = yyjson_obj_get(mappings, "properties");
 			if (properties) {
 				CollectAllPathTypes(properties, "", all_path_types);
-				CollectTextFieldsWithKeyword(properties, "", result.text_fields_with_keyword);
+				CollectSubfields(properties, "", result.subfields);
+				CollectDocValueLimitedFields(properties, "", result.ignore_above_fields, result.normalized_fields);
 			}
 		}
 	}
@@ -716,18 +839,26 @@ ElasticsearchSchema ResolveElasticsearchSchema(const ElasticsearchConfig &config
 		}
 	}
 
+	SelectSubfieldTargets(result);
+
+	result.max_terms_count = GetMaxTermsCount(client, index);
+
 	// Sample documents to detect arrays and unmapped fields.
 	// Uses the user-provided query (base_query) if specified, otherwise match_all.
 	// This is the best approximation of the actual query because filter pushdown (WHERE clauses)
 	// happens after bind time, so the final query with pushed-down filters is not yet known.
-	std::string sampling_query = R"({"query": {"match_all": {}}})";
+	// The total number of matching documents is counted as well (track_total_hits), it is the cardinality estimate
+	// of the scan for DuckDB's optimizer.
+	std::string sampling_query = R"({"track_total_hits": true, "query": {"match_all": {}}})";
 	if (!base_query.empty()) {
-		sampling_query = R"({"query": )" + base_query + "}";
+		sampling_query = R"({"track_total_hits": true, "query": )" + base_query + "}";
 	}
 	if (sample_size > 0 && !result.field_paths.empty()) {
 		SampleResult sample_result = SampleDocuments(client, index, sampling_query, result.field_paths, result.es_types,
 		                                             result.all_mapped_paths, sample_size);
 
+		result.document_count = sample_result.total_hits;
+
 		// Wrap types in LIST for fields detected as arrays.
 		for (size_t i = 0; i < result.field_paths.size(); i++) {
 			if (sample_result.array_fields.count(result.field_paths[i])) {
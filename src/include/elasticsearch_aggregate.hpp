@@ -0,0 +1,112 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "elasticsearch_client.hpp"
+
+#include <set>
+#include <string>
+
+namespace duckdb {
+
+// How the buckets of an aggregation request are enumerated.
+enum class ElasticsearchAggregateMode : uint8_t {
+	// A composite aggregation (levels[0]), paginated with after_key until all buckets are read. Top-level, or below
+	// a nested aggregation for aggregates over nested documents.
+	COMPOSITE,
+	// A terms aggregation (levels[0]) returning the top buckets in a single request, followed by the bucket of a
+	// sibling missing aggregation named "missing" (documents without a value) when it is not empty. Approximate:
+	// the counts of the top buckets are bounded by doc_count_error_upper_bound, which is logged.
+	TERMS,
+	// An aggregation (levels[0]) returning all buckets in a single request, followed by the missing bucket like
+	// TERMS: a geohash_grid, which cannot be paginated with a composite aggregation. A response with page_size
+	// buckets fails the query instead of returning an incomplete result.
+	ALL_BUCKETS,
+	// Any aggregation tree, read in a single request.
+	SINGLE
+};
+
+// Describes how one output column of an aggregation scan is read from a bucket.
+struct ElasticsearchAggregateColumn {
+	std::string name;
+	LogicalType type;
+
+	// The object value_path is relative to: 0 is the aggregations object of the response, i > 0 the bucket of the
+	// i-th nested bucket aggregation (see levels in the bind data).
+	idx_t level = 1;
+
+	// Dotted path of the value inside the bucket (e.g. "key.g0" or "key", "doc_count", "m0.sum"). STRUCT and LIST
+	// columns are converted like document fields, VARIANT columns hold the JSON value as is.
+	std::string value_path;
+
+	// Optional dotted path of a document count inside the bucket. When it resolves to 0, the column is NULL.
+	// Used for metrics like sum/min/max/avg, which are NULL in SQL for groups without any value.
+	std::string null_if_zero_path;
+
+	// Divisor applied to numeric values, rounding the quotient. Used for floor(x / w) groups, which read the histogram
+	// key floor(x / w) * w.
+	double divisor = 1;
+
+	// Optional dotted path of a top_hits "hits" array inside the bucket (e.g. "m0.hit.hits"). When set, the column
+	// is read from the first hit like a document column: value_path is a _source field path, "_id" or
+	// "_unmapped_", and es_type is the Elasticsearch type of the field. The column is NULL if there is no hit.
+	// For a level over a hits array (see levels in the bind data) hits_path is "." and the bucket is the hit.
+	std::string hits_path;
+	std::string es_type;
+};
+
+// Bind data for the elasticsearch_aggregate scan.
+// Produced by the aggregate pushdown in the optimizer extension, which replaces an aggregate over an
+// elasticsearch_query scan with a scan over the aggregation buckets.
+struct ElasticsearchAggregateBindData : public TableFunctionData {
+	ElasticsearchConfig config;
+	std::string index;
+
+	// Logger for HTTP request logging, inherited from the elasticsearch_query bind data.
+	shared_ptr<Logger> logger;
+
+	ElasticsearchAggregateMode mode = ElasticsearchAggregateMode::COMPOSITE;
+
+	// The search request body (query and aggs). For composite aggregations the "after" key is added per page.
+	std::string request;
+
+	// Paths of the nested bucket aggregations whose buckets are flattened into rows: levels[0] is relative to the
+	// aggregations object of the response, levels[i] to a bucket of levels[i - 1] (e.g. {"groups"} or
+	// {"by_city", "per_day"}). Each row is one combination of buckets, one per level. The last level may also be
+	// the hits array of a top_hits aggregation (e.g. {"groups", "m0.hits.hits"}), whose hits are the buckets.
+	vector<std::string> levels;
+
+	// Keys from the root of the request to the paged composite aggregation in COMPOSITE mode, e.g. {"aggs", "groups"}
+	// or {"aggs", "groups", "aggs", "groups"} below a nested aggregation. Unlike levels[0] it is not a dotted path:
+	// aggregation names may contain dots, and sub-aggregations may be under "aggs" or "aggregations". In the
+	// response the composite is found through the aggregation names alone (every second key).
+	vector<std::string> composite_path;
+
+	// Number of buckets requested per composite page (or the size of a grid aggregation). A shorter page is the
+	// last one.
+	idx_t page_size = 0;
+
+	// Whether buckets are filtered by a bucket_selector (HAVING). Filtered pages can be shorter than page_size
+	// or even empty before the last one, so paging continues until Elasticsearch returns no after_key.
+	bool filtered_buckets = false;
+
+	// Whether the request was generated by the aggregate pushdown, which may still rewrite it (approximate top-k).
+	// Requests passed to the elasticsearch_aggregate table function are sent as written.
+	bool generated = false;
+
+	// Output columns in the order of the scan's returned types.
+	vector<ElasticsearchAggregateColumn> columns;
+
+	// Mapped field paths of the index, used to collect the _unmapped_ column of top hits.
+	std::set<std::string> mapped_paths;
+};
+
+// Get the table function that scans the buckets of an aggregation request.
+// Instantiated by the optimizer extension for pushed aggregates, and registered as elasticsearch_aggregate
+// for raw aggregation requests.
+TableFunction GetElasticsearchAggregateFunction();
+
+// Register the elasticsearch_aggregate table function.
+void RegisterElasticsearchAggregateFunction(ExtensionLoader &loader);
+
+} // namespace duckdb
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "duckdb.hpp"
+#include "duckdb/optimizer/optimizer_extension.hpp"
+
+namespace duckdb {
+
+// Aggregate pushdown - finds GROUP BY aggregates directly above an elasticsearch_query scan (with optional
+// intermediate PROJECTION nodes) and replaces them with an elasticsearch_aggregate scan that reads the buckets
+// of an equivalent Elasticsearch aggregation. Only the aggregated rows cross the wire instead of every document.
+// Disabled with the elasticsearch_aggregate_pushdown setting.
+void OptimizeAggregatePushdown(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan);
+
+} // namespace duckdb
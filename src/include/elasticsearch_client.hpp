@@ -49,9 +49,16 @@ public:
 	ElasticsearchResponse ScrollNext(const std::string &scroll_id, const std::string &scroll_time);
 	ElasticsearchResponse ClearScroll(const std::string &scroll_id);
 
+	// Aggregation-only search (size=0). Only the aggregations part of the response is returned.
+	ElasticsearchResponse Aggregate(const std::string &index, const std::string &query);
+
 	// Get index mapping.
 	ElasticsearchResponse GetMapping(const std::string &index);
 
+	// Get an index setting (e.g. "index.max_terms_count") of every index matching index. Settings left at their
+	// default value are not returned.
+	ElasticsearchResponse GetSetting(const std::string &index, const std::string &setting);
+
 private:
 	ElasticsearchConfig config_;
 	shared_ptr<Logger> logger_;
@@ -6,6 +6,7 @@
 #include "duckdb/planner/expression.hpp"
 #include "yyjson.hpp"
 
+#include <set>
 #include <string>
 
 namespace duckdb {
@@ -27,6 +28,12 @@ yyjson_mut_val *ConvertDuckDBToJSON(yyjson_mut_doc *doc, const Value &value);
 // Convert a yyjson value to a VariantValue for building VARIANT column data.
 VariantValue ConvertYyjsonToVariantValue(yyjson_val *val);
 
+// Collect fields from _source that are not in the schema's mapped paths.
+// Returns a VariantValue of unmapped fields or a null VariantValue if none found.
+// Used to populate the _unmapped_ output column of scanned documents.
+VariantValue CollectUnmappedFields(yyjson_val *source, const std::set<std::string> &mapped_paths,
+                                   const std::string &prefix = "");
+
 // Convert WKB binary (GEOMETRY internal format) to a GeoJSON string.
 // Used by filter pushdown to convert GEOMETRY constants to GeoJSON for Elasticsearch query DSL.
 std::string WKBToGeoJSON(const string_t &wkb);
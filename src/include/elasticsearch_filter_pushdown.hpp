@@ -3,6 +3,7 @@
 #include "duckdb.hpp"
 #include "duckdb/planner/table_filter.hpp"
 #include "duckdb/planner/table_filter_set.hpp"
+#include "duckdb/planner/expression/bound_function_expression.hpp"
 #include "elasticsearch_schema.hpp"
 #include "yyjson.hpp"
 
@@ -16,6 +17,32 @@ struct FilterTranslationResult {
 	yyjson_mut_val *es_query;
 };
 
+// A boolean predicate tree over one or more columns (e.g. "level = 'error' OR status >= 500"), pushed by
+// pushdown_complex_filter since a TableFilterSet can only hold filters tied to a single column.
+// Negations are pushed down to the leaves (De Morgan), so inner nodes are only AND and OR.
+struct ElasticsearchBooleanFilter {
+	// CONJUNCTION_AND or CONJUNCTION_OR for inner nodes, INVALID for leaves.
+	ExpressionType type = ExpressionType::INVALID;
+	vector<unique_ptr<ElasticsearchBooleanFilter>> children;
+
+	// Leaf: a single-column filter on the Elasticsearch field path column_name (not wrapped in StructFilter).
+	string column_name;
+	unique_ptr<TableFilter> filter;
+	// Leaf is NOT filter. Matches only documents where the field exists, since in SQL NOT of a comparison
+	// against NULL is NULL and not true.
+	bool negated = false;
+
+	// Path of a nested field if the node is a predicate on its nested documents (e.g. from
+	// len(list_filter(users, lambda u: u.email = 'x')) > 0), which must hold for a single nested document.
+	// The node is then wrapped in a nested query and the columns of its leaves are fields below the path.
+	string nested_path;
+
+	// Leaf evaluated by a Painless script instead of a filter on column_name, for predicates on computed
+	// expressions of fields (e.g. bytes_out - bytes_in > 1000000). Negations are compiled into the script.
+	string script;
+	child_list_t<Value> script_params;
+};
+
 // Translates DuckDB TableFilter objects into Elasticsearch Query DSL.
 // Returns a FilterTranslationResult containing the translated Elasticsearch query (nullptr if no filters).
 //
@@ -38,4 +65,41 @@ struct FilterTranslationResult {
 FilterTranslationResult TranslateFilters(yyjson_mut_doc *doc, const TableFilterSet &filters,
                                          const vector<string> &column_names, const ElasticsearchSchema &schema);
 
+// Extracts the constant pattern and the case sensitivity of a regexp_matches / regexp_full_match call.
+// Returns false if the pattern or the options are not constant, or for options other than 'c' and 'i'.
+bool ExtractRegexpArguments(const BoundFunctionExpression &func_expr, string &pattern, bool &case_insensitive);
+
+// Translates an RE2 regular expression into the Lucene syntax of Elasticsearch regexp queries, which always
+// match the whole value. With partial_match (regexp_matches) unanchored ends are padded with .* so the pattern
+// may match anywhere. A leading (?i) sets case_insensitive. Returns false if the pattern uses a construct without
+// a safe Lucene equivalent (anchors inside the pattern, word boundaries, flag groups, POSIX and Unicode classes,
+// back-references), in which case the filter must be evaluated by DuckDB.
+bool TranslateRegexToLucene(const string &pattern, bool partial_match, string &lucene_pattern, bool &case_insensitive);
+
+// Recognizes a date part of a column, either a part function (year(col), hour(col), ...) or date_part('part', col)
+// with a constant part, which is also what extract(part FROM col) binds to. Sets part to the canonical name (year,
+// quarter, month, day, dayofyear, dayofweek, isodow, hour, minute or second). Returns false for other expressions
+// and parts. The column is the last child of the function.
+bool ExtractDatePart(const Expression &expr, string &part);
+
+// Translates a time relative to the current time into Elasticsearch date math: now(), current_timestamp and
+// current_date, with constant intervals added or subtracted and rounded with date_trunc or a cast to DATE, e.g.
+// date_trunc('day', now()) - INTERVAL 7 DAY -> now/d-7d. Sets rounded if the date math contains a rounding.
+// Returns false for other expressions.
+bool ExtractDateMath(const Expression &expr, string &date_math, bool &rounded);
+
+// Recognizes a case conversion of a column, lower(col) or upper(col) and their aliases lcase and ucase, and sets
+// upper for upper(col). Returns false for other expressions. The column is the only child of the function.
+bool ExtractCaseConversion(const Expression &expr, bool &upper);
+
+// Checks whether a constant compared with a case conversion can be matched case-insensitively by Elasticsearch:
+// a non-NULL ASCII string (the case folding of case_insensitive term queries) unchanged by the conversion, as
+// lower(col) = 'Web' is never true.
+bool IsCaseConvertedValue(const Value &value, bool upper);
+
+// Translates a boolean predicate tree into nested bool.must / bool.should / bool.must_not queries.
+// Returns nullptr if the tree cannot be translated.
+yyjson_mut_val *TranslateBooleanFilter(yyjson_mut_doc *doc, const ElasticsearchBooleanFilter &filter,
+                                       const ElasticsearchSchema &schema);
+
 } // namespace duckdb
@@ -2,11 +2,17 @@
 
 #include "duckdb.hpp"
 #include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/planner/bound_result_modifier.hpp"
+#include "duckdb/planner/operator/logical_get.hpp"
+#include "duckdb/planner/operator/logical_projection.hpp"
+#include "duckdb/planner/operator/logical_unnest.hpp"
+#include "elasticsearch_query.hpp"
+#include "elasticsearch_schema.hpp"
 
 namespace duckdb {
 
 // Optimizer extension for Elasticsearch plan rewriting.
-// Performs two transformations on the logical plan after all built-in optimizer passes:
+// Performs five transformations on the logical plan after all built-in optimizer passes:
 // 1. _id field semantic optimization - in Elasticsearch, the _id metadata field is always
 //    non-null (every document has an _id). This allows compile-time optimization:
 //      - _id IS NOT NULL  ->  always true   ->  filter stripped (no-op)
@@ -15,7 +21,15 @@ namespace duckdb {
 //    ElasticsearchPushdownComplexFilter pushes to block the FilterCombiner from re-pushing
 //    deferred filters (text fields without .keyword, comparison/IN on geo fields). The guard
 //    is semantically "_id IS NOT NULL" and gets optimized away as part of the always-true case.
-// 2. LIMIT/OFFSET pushdown - finds LIMIT operators above Elasticsearch scans, stores the
+// 2. Aggregate pushdown - replaces GROUP BY aggregates above Elasticsearch scans with a scan
+//    over the buckets of an equivalent Elasticsearch aggregation (elasticsearch_aggregate_pushdown.cpp).
+// 3. Top-N pushdown - finds TOP_N (or LIMIT over ORDER BY) above Elasticsearch scans whose sort
+//    keys are doc-value fields and sends them as a sort clause with size = limit + offset. The
+//    TOP_N operator stays in the plan and orders the few returned rows.
+// 4. Sort pushdown - finds ORDER BY without LIMIT above Elasticsearch scans whose sort keys
+//    are doc-value fields and sends them as a sort clause. The scroll returns the documents
+//    in sort order, so the ORDER BY operator is removed from the plan.
+// 5. LIMIT/OFFSET pushdown - finds LIMIT operators above Elasticsearch scans, stores the
 //    limit and offset values in the bind data and removes the LIMIT operator from the plan
 //    so that DuckDB does not duplicate limit enforcement.
 class ElasticsearchOptimizerExtension : public OptimizerExtension {
@@ -23,8 +37,58 @@ public:
 	ElasticsearchOptimizerExtension();
 };
 
+// An elasticsearch_query scan below an optional chain of projections (PROJECTION* -> GET).
+// Used by the plan rewrites that replace operators above a scan with work done by Elasticsearch.
+struct ElasticsearchScanMatch {
+	// Projections between the matched operator and the scan, from top to bottom.
+	vector<reference<LogicalProjection>> projections;
+	optional_ptr<LogicalGet> get;
+	// UNNEST of a nested field between the projections and the scan (aggregate pushdown only). Its output
+	// resolves to the nested field at nested_path, columns of the scan itself are not resolved.
+	optional_ptr<LogicalUnnest> unnest;
+	string nested_path;
+};
+
+// Match PROJECTION* -> GET(elasticsearch_query) starting at op.
+bool MatchElasticsearchScan(LogicalOperator &op, ElasticsearchScanMatch &match);
+
+// Replace column references to the matched projections with the projected expressions, so that the expression
+// only references the scan. Returns false if a column reference cannot be resolved.
+bool InlineProjections(unique_ptr<Expression> &expr, const ElasticsearchScanMatch &match);
+
+// An Elasticsearch field referenced by an expression over the scan.
+struct ElasticsearchFieldRef {
+	// Dotted field path, also the key of the schema maps (e.g. "employee.address.city").
+	string path;
+	// Elasticsearch type from the mapping (e.g. "keyword", "integer").
+	string es_type;
+	// DuckDB type of the referenced column or struct field.
+	LogicalType type;
+};
+
+// Resolve a column reference to the matched scan (after InlineProjections) to its bind schema column id.
+// Column layout: [_id (0), ...fields... (1 to N), _unmapped_ (N+1)].
+bool ResolveElasticsearchColumnId(const Expression &expr, const ElasticsearchScanMatch &match, idx_t &col_id);
+
+// Resolve a column reference or struct_extract chain over the matched scan (after InlineProjections) to a field.
+// Returns false for other expressions and for the _id and _unmapped_ columns. With a matched UNNEST, only the
+// nested documents (the UNNEST output) and their fields are resolved.
+bool ResolveElasticsearchField(const Expression &expr, const ElasticsearchScanMatch &match,
+                               ElasticsearchFieldRef &result);
+
+// Get the field that holds doc values for a resolved field (used for aggregations and sorting), e.g.
+// "name.keyword" for a text field with a .keyword subfield. Returns an empty string when the field has no
+// single-valued doc values (text without .keyword, objects, geo fields, fields detected as arrays), for keyword
+// fields with ignore_above, whose longer values have no doc values, and for keyword fields with a normalizer.
+string GetDocValueField(const ElasticsearchFieldRef &field, const ElasticsearchSchema &schema);
+
+// Translate ORDER BY keys over the matched scan to Elasticsearch sort keys on doc-value fields.
+// Returns false if any key is not a sortable field.
+bool TranslateSortKeys(const vector<BoundOrderByNode> &orders, const ElasticsearchScanMatch &match,
+                       vector<ElasticsearchSortKey> &sort);
+
 // The main optimization function that rewrites the Elasticsearch logical plan.
-// Recursively walks the plan tree to optimize _id filters and push down LIMIT/OFFSET.
+// Recursively walks the plan tree to optimize _id filters and push down aggregates, Top-N and LIMIT/OFFSET.
 void OptimizeElasticsearchPlan(OptimizerExtensionInput &input, unique_ptr<LogicalOperator> &plan);
 
 } // namespace duckdb
@@ -1,13 +1,98 @@
 #pragma once
 
 #include "duckdb.hpp"
+#include "duckdb/function/table_function.hpp"
+#include "duckdb/planner/table_filter_set.hpp"
+#include "elasticsearch_client.hpp"
+#include "elasticsearch_filter_pushdown.hpp"
+#include "elasticsearch_schema.hpp"
+#include "yyjson.hpp"
 
 namespace duckdb {
 
+using namespace duckdb_yyjson;
+
+// Column id of the _score virtual column: the relevance score of each hit, outside the bind schema's column layout
+// [_id (0), ...fields... (1 to N), _unmapped_ (N+1)]. Not part of SELECT *, it has to be selected explicitly.
+const column_t ELASTICSEARCH_SCORE_COLUMN_ID = VIRTUAL_COLUMN_START;
+
+// A sort key pushed down to Elasticsearch (set by the optimizer extension for ORDER BY, with or without LIMIT).
+struct ElasticsearchSortKey {
+	std::string field; // doc-value field to sort on (e.g. "amount" or "name.keyword"), or "_score"
+	bool descending = false;
+	bool nulls_first = false; // documents without a value sort first ("missing": "_first")
+};
+
+// Bind data for the elasticsearch_query function.
+struct ElasticsearchQueryBindData : public TableFunctionData {
+	ElasticsearchConfig config;
+	std::string index;
+	std::string base_query; // user-provided query (optional, merged with filters)
+
+	// Logger for HTTP request logging, captured from ClientContext during bind.
+	shared_ptr<Logger> logger;
+
+	// Resolved Elasticsearch schema containing all mapping and sampling information.
+	// Produced by ResolveElasticsearchSchema() and consumed by query building, filter pushdown and scanning.
+	ElasticsearchSchema schema;
+
+	// Sample size for array detection (0 = disabled).
+	// Populated from elasticsearch_sample_size setting, overridable by named parameter.
+	int64_t sample_size;
+
+	// Scroll and batch settings.
+	// Populated from extension settings, not overridable by named parameters.
+	int64_t batch_size;                  // from elasticsearch_batch_size
+	int64_t batch_size_threshold_factor; // from elasticsearch_batch_size_threshold_factor
+	std::string scroll_time;             // from elasticsearch_scroll_time
+
+	// Limit pushdown values (set by optimizer extension).
+	// -1 means no limit, 0 means no offset.
+	int64_t limit = -1;
+	int64_t offset = 0;
+
+	// Sort pushdown (set by optimizer extension for ORDER BY, together with the limit for Top-N).
+	// Empty means documents are returned in index order.
+	vector<ElasticsearchSortKey> sort;
+
+	// Boolean predicate trees over several columns (set by pushdown_complex_filter for AND/OR/NOT filters that
+	// cannot be expressed as per-column table filters, and for predicates on the documents of nested fields).
+	// Combined with the table filters in the query clause.
+	vector<unique_ptr<ElasticsearchBooleanFilter>> boolean_filters;
+};
+
 // Register the elasticsearch_query table function.
 void RegisterElasticsearchQueryFunction(ExtensionLoader &loader);
 
+// Register the full-text predicate functions es_match, es_match_phrase and es_query_string. They are only
+// evaluated by Elasticsearch (pushed down by pushdown_complex_filter) and fail when DuckDB has to evaluate them.
+void RegisterElasticsearchFullTextFunctions(ExtensionLoader &loader);
+
+// Initialize a connection config with the defaults, the extension settings (SSL verification, timeout and retries)
+// and DuckDB's HTTP proxy settings. Shared by the elasticsearch_query and elasticsearch_aggregate bind functions.
+void InitElasticsearchConfig(ClientContext &context, ElasticsearchConfig &config);
+
+// Apply a connection named parameter (host, port, username, password, use_ssl, verify_ssl, timeout, max_retries,
+// retry_interval or retry_backoff_factor) to a config. Returns false for other parameters.
+bool SetElasticsearchConfigParameter(const string &name, const Value &value, ElasticsearchConfig &config);
+
+// Add the connection named parameters to a table function.
+void AddElasticsearchConfigParameters(TableFunction &function);
+
 // Helper function for optimizer extension to set limit/offset pushdown values in bind data.
 void SetElasticsearchLimitOffset(FunctionData &bind_data, int64_t limit, int64_t offset);
 
+// Build the query clause for an elasticsearch_query scan by merging the base query with the pushed filters
+// (the table filters and the boolean filters of the bind data). column_ids contains indices into the bind
+// schema ([_id (0), ...fields... (1 to N), _unmapped_ (N+1)]) and filter indices in the TableFilterSet are
+// positions within column_ids. Unless scoring is set (relevance scores are read or sorted on), the clauses are
+// combined in the filter context, which skips scoring and lets Elasticsearch cache them. Returns match_all if there
+// is neither a base query nor a filter. The returned value is allocated in doc.
+yyjson_mut_val *BuildElasticsearchQueryClause(yyjson_mut_doc *doc, const ElasticsearchQueryBindData &bind_data,
+                                              const TableFilterSet *filters, const vector<idx_t> &column_ids,
+                                              bool scoring);
+
+// Build a sort array ([{field: {"order": ..., "missing": ...}}, ...]) for the given sort keys, allocated in doc.
+yyjson_mut_val *BuildElasticsearchSort(yyjson_mut_doc *doc, const vector<ElasticsearchSortKey> &sort);
+
 } // namespace duckdb
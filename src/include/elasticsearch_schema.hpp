@@ -10,6 +10,18 @@
 
 namespace duckdb {
 
+// A multi-field of a field in the Elasticsearch mapping (an entry of its "fields"), indexing the same values
+// differently, e.g. the .keyword subfield of a text field.
+struct ElasticsearchSubfield {
+	// Full path of the subfield (e.g. "name.raw").
+	string path;
+	// Elasticsearch type of the subfield (e.g. "keyword", "wildcard", "text").
+	string es_type;
+	// Normalizer of keyword subfields and analyzer of text subfields, empty if not set.
+	string normalizer;
+	string analyzer;
+};
+
 // Unified schema information resolved from Elasticsearch mapping and document sampling.
 // This is the single canonical representation of the schema for an Elasticsearch index (or index pattern).
 // It is produced by ResolveElasticsearchSchema() and consumed by all downstream components:
@@ -42,14 +54,48 @@ struct ElasticsearchSchema {
 	// Text fields need .keyword subfield for exact matching in filters.
 	std::unordered_set<string> text_fields;
 
-	// Set of text field names/paths that have a .keyword subfield in the Elasticsearch mapping.
-	// Only these text fields support filter pushdown (except IS NULL/IS NOT NULL which work on any field).
+	// Set of text field names/paths that have a keyword subfield without a normalizer in the Elasticsearch mapping
+	// (.keyword, or another name such as .raw, see keyword_subfields). Only these text fields support filter
+	// pushdown (except IS NULL/IS NOT NULL which work on any field).
 	std::unordered_set<string> text_fields_with_keyword;
 
+	// Multi-fields of each field name/path, in mapping order.
+	std::unordered_map<string, vector<ElasticsearchSubfield>> subfields;
+
+	// Subfields chosen from the multi-fields as the cheapest correct targets of predicates, by field name/path:
+	// - keyword_subfields: a keyword subfield without a normalizer (.keyword preferred), holding the raw value of a
+	//   text field for exact matches, ranges, sorting and aggregations (e.g. "name" -> "name.keyword")
+	// - lowercase_subfields: a keyword subfield with the built-in lowercase normalizer, for case-insensitive
+	//   filters (lower(col) = 'x') instead of case_insensitive term queries (e.g. "host" -> "host.lowercase")
+	// - wildcard_subfields: a wildcard subfield, for LIKE patterns and regular expressions that would otherwise
+	//   need an expensive leading-wildcard or regexp query on a keyword field (e.g. "url" -> "url.wildcard")
+	std::unordered_map<string, string> keyword_subfields;
+	std::unordered_map<string, string> lowercase_subfields;
+	std::unordered_map<string, string> wildcard_subfields;
+
+	// Keyword fields and subfields (e.g. "name.keyword") with ignore_above in the mapping of any matching index.
+	// Longer values are neither indexed nor stored in doc values, so they would sort and group as missing.
+	std::unordered_set<string> ignore_above_fields;
+
+	// Keyword fields with a normalizer in the mapping of any matching index (e.g. "lowercase"). Their doc values are
+	// the normalized terms, so 'Foo' and 'foo' would sort and group as the same value.
+	std::unordered_set<string> normalized_fields;
+
 	// Set of field names/paths whose Elasticsearch type is "geo_point" or "geo_shape".
 	// Geo fields use spatial predicates (ST_Within, ST_DWithin, ST_Distance etc.) for pushdown;
 	// standard comparison (=, !=, <, >, <=, >=) and IN operators cannot be pushed to Elasticsearch.
 	std::unordered_set<string> geo_fields;
+
+	// Number of documents matching the base query, counted by the sampling request (-1 if sampling is disabled or
+	// failed). Used as the cardinality estimate of the scan.
+	int64_t document_count = -1;
+
+	// Default value of the index.max_terms_count setting.
+	static constexpr int64_t DEFAULT_MAX_TERMS_COUNT = 65536;
+
+	// Maximum number of values in a terms query (the index.max_terms_count setting, the lowest one of all matching
+	// indices). Larger IN lists are split into several terms queries.
+	int64_t max_terms_count = DEFAULT_MAX_TERMS_COUNT;
 };
 
 // Resolve schema for an Elasticsearch index, with caching.
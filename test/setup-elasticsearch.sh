@@ -37,4 +37,18 @@ curl --fail-with-body -s -X POST -u elastic:test http://localhost:9200/_bulk \
 echo "Refreshing test index"
 curl --fail-with-body -s -X POST -u elastic:test http://localhost:9200/test/_refresh && echo
 
+# Create the longs index, with long values beyond the precision of doubles (2^53) and a normalized keyword.
+echo "Deleting longs index if exists"
+curl -fs -X DELETE -u elastic:test http://localhost:9200/longs && echo || true
+
+echo "Creating longs index"
+curl --fail-with-body -s -X PUT -u elastic:test http://localhost:9200/longs \
+  -H "Content-Type: application/json" \
+  --data '{"mappings": {"properties": {"category": {"type": "keyword"}, "code": {"type": "keyword", "normalizer": "lowercase"}, "id": {"type": "long"}}}}' && echo
+
+echo "Loading longs data"
+curl --fail-with-body -s -X POST -u elastic:test "http://localhost:9200/longs/_bulk?refresh=true" \
+  -H "Content-Type: application/x-ndjson" \
+  --data-binary $'{"index": {}}\n{"category": "a", "code": "Foo", "id": 9007199254740993}\n{"index": {}}\n{"category": "a", "code": "foo", "id": 9007199254740992}\n{"index": {}}\n{"category": "b", "code": "Bar", "id": 1}\n' && echo
+
 echo "Setup complete"